@@ -0,0 +1,165 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+
+// Compares the event queue backends of the smacc state machine (boost::statechart::fifo_worker vs
+// smacc::SmaccLockFreeFifoWorker). Several producer threads post events at full speed into an asynchronous
+// state machine (the same way ros callbacks do it) and it is measured the throughput (events/sec) and the
+// latency from the postEvent call until the state machine reacts to the event.
+//
+// usage: smacc_fifo_worker_benchmark [producers] [events_per_producer] [rate_hz_per_producer]
+// (rate 0 means that producers post as fast as they can, then the latency mostly measures the queue backlog)
+
+#include <smacc/smacc_lockfree_fifo_worker.h>
+
+#include <boost/statechart/asynchronous_state_machine.hpp>
+#include <boost/statechart/custom_reaction.hpp>
+#include <boost/statechart/event.hpp>
+#include <boost/statechart/fifo_scheduler.hpp>
+#include <boost/statechart/fifo_worker.hpp>
+#include <boost/statechart/simple_state.hpp>
+#include <boost/thread.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sc = boost::statechart;
+namespace mpl = boost::mpl;
+
+namespace smacc_benchmark
+{
+typedef std::chrono::steady_clock Clock;
+
+struct EvBenchmark : sc::event<EvBenchmark>
+{
+  Clock::time_point postTime;
+};
+
+std::vector<int64_t> latenciesNs;
+
+template <typename TScheduler>
+struct StIdle;
+
+template <typename TScheduler>
+struct SmBenchmark : sc::asynchronous_state_machine<SmBenchmark<TScheduler>, StIdle<TScheduler>, TScheduler>
+{
+  SmBenchmark(typename TScheduler::processor_context ctx)
+      : sc::asynchronous_state_machine<SmBenchmark<TScheduler>, StIdle<TScheduler>, TScheduler>(ctx)
+  {
+  }
+};
+
+template <typename TScheduler>
+struct StIdle : sc::simple_state<StIdle<TScheduler>, SmBenchmark<TScheduler>>
+{
+  typedef sc::custom_reaction<EvBenchmark> reactions;
+
+  sc::result react(const EvBenchmark &ev)
+  {
+    latenciesNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - ev.postTime).count());
+    return this->discard_event();
+  }
+};
+
+template <typename TWorker>
+void runBenchmark(std::string name, int producers, int eventsPerProducer, double rateHz)
+{
+  typedef sc::fifo_scheduler<TWorker, std::allocator<void>> Scheduler;
+
+  latenciesNs.clear();
+  latenciesNs.reserve((size_t)producers * eventsPerProducer);
+
+  Scheduler scheduler(true);
+  auto processor = scheduler.template create_processor<SmBenchmark<Scheduler>>();
+  scheduler.initiate_processor(processor);
+
+  boost::thread consumer(boost::bind(&Scheduler::operator(), &scheduler, 0));
+
+  auto start = Clock::now();
+  std::vector<boost::thread> producerThreads;
+  for (int i = 0; i < producers; i++)
+  {
+    producerThreads.emplace_back([&] {
+      auto period = std::chrono::nanoseconds(rateHz > 0 ? (int64_t)(1e9 / rateHz) : 0);
+      auto next = Clock::now();
+      for (int j = 0; j < eventsPerProducer; j++)
+      {
+        if (rateHz > 0)
+        {
+          next += period;
+          while (Clock::now() < next)
+            ;
+        }
+
+        auto *ev = new EvBenchmark();
+        ev->postTime = Clock::now();
+        boost::intrusive_ptr<EvBenchmark> evptr = ev;
+        scheduler.queue_event(processor, evptr);
+      }
+    });
+  }
+
+  for (auto &t : producerThreads)
+    t.join();
+
+  // wait until all the events are processed
+  size_t total = (size_t)producers * eventsPerProducer;
+  while (true)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    // the event processing is serialized in the consumer thread, the size is checked through the queue itself
+    boost::mutex m;
+    boost::condition_variable cv;
+    bool done = false;
+    size_t processed = 0;
+    scheduler.queue_work_item([&] {
+      boost::lock_guard<boost::mutex> l(m);
+      processed = latenciesNs.size();
+      done = true;
+      cv.notify_one();
+    });
+
+    boost::unique_lock<boost::mutex> l(m);
+    while (!done)
+      cv.wait(l);
+
+    if (processed >= total)
+      break;
+  }
+
+  auto ellapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+  scheduler.terminate();
+  consumer.join();
+
+  std::sort(latenciesNs.begin(), latenciesNs.end());
+  auto percentile = [&](double p) { return latenciesNs[std::min(latenciesNs.size() - 1, (size_t)(p * latenciesNs.size()))] / 1000.0; };
+
+  printf("%-28s producers: %2d  events: %9zu  throughput: %12.0f events/sec  latency p50: %9.2f us  p99: %9.2f us  max: %9.2f us\n",
+         name.c_str(), producers, total, total / ellapsed, percentile(0.5), percentile(0.99),
+         latenciesNs.back() / 1000.0);
+}
+} // namespace smacc_benchmark
+
+int main(int argc, char **argv)
+{
+  using namespace smacc_benchmark;
+  int producers = argc > 1 ? std::atoi(argv[1]) : 4;
+  int eventsPerProducer = argc > 2 ? std::atoi(argv[2]) : 200000;
+  double rateHz = argc > 3 ? std::atof(argv[3]) : 0;
+
+  for (int p = 1; p <= producers; p *= 2)
+  {
+    runBenchmark<sc::fifo_worker<std::allocator<void>>>("boost::fifo_worker", p, eventsPerProducer, rateHz);
+    runBenchmark<smacc::SmaccLockFreeFifoWorker<std::allocator<void>>>("smacc::SmaccLockFreeFifoWorker", p, eventsPerProducer, rateHz);
+  }
+
+  return 0;
+}
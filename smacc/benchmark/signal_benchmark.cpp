@@ -0,0 +1,185 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+
+// Compares the invocation cost of boost::signals2 (what SmaccSignal is) with smacc::SmaccLightSignal, single
+// threaded (SmaccNullMutex) and synchronized (std::mutex), for different numbers of connected slots. It
+// also measures connecting and disconnecting a scope of slots, as the state scoped subscriptions do on each state.
+//
+// usage: smacc_signal_benchmark [invocations] [json_output_file]
+
+#include <smacc/smacc_light_signal.h>
+
+#include <boost/signals2/signal.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace smacc_benchmark
+{
+typedef std::chrono::steady_clock Clock;
+
+struct Message
+{
+  int value;
+};
+
+struct Subscriber
+{
+  Subscriber() : sum(0) {}
+
+  void onMessage(const Message &msg)
+  {
+    sum += msg.value;
+  }
+
+  long sum;
+};
+
+struct Result
+{
+  std::string signal;
+  int slots;
+  double invocationNs;
+  double connectDisconnectNs;
+};
+
+template <typename TSignal, typename TConnection>
+void disconnectSlots(TSignal &, std::vector<TConnection> &connections, const void *)
+{
+  for (auto &connection : connections)
+  {
+    connection.disconnect();
+  }
+}
+
+template <typename Mutex>
+void disconnectSlots(smacc::SmaccLightSignal<void(const Message &), Mutex> &signal,
+                     std::vector<smacc::SmaccLightConnection> &, const void *scope)
+{
+  signal.disconnect(scope);
+}
+
+template <typename TSignal>
+Result run(const std::string &name, int slots, unsigned long invocations)
+{
+  TSignal signal;
+  std::vector<Subscriber> subscribers(slots);
+  std::vector<decltype(signal.connect(std::function<void(const Message &)>(), nullptr))> connections;
+
+  for (auto &subscriber : subscribers)
+  {
+    auto *s = &subscriber;
+    connections.push_back(signal.connect([s](const Message &msg) { s->onMessage(msg); }, &subscribers));
+  }
+
+  Message msg{1};
+  for (unsigned long i = 0; i < invocations / 10; i++)
+  {
+    signal(msg);
+  }
+
+  auto start = Clock::now();
+  for (unsigned long i = 0; i < invocations; i++)
+  {
+    msg.value = i & 1;
+    signal(msg);
+  }
+  auto invocationTime = Clock::now() - start;
+
+  // state scoped subscriptions: connect the slots on entry, disconnect them on exit
+  const unsigned long cycles = 10000;
+  start = Clock::now();
+  for (unsigned long i = 0; i < cycles; i++)
+  {
+    connections.clear();
+    for (auto &subscriber : subscribers)
+    {
+      auto *s = &subscriber;
+      connections.push_back(signal.connect([s](const Message &msg) { s->onMessage(msg); }, &subscribers));
+    }
+
+    disconnectSlots(signal, connections, &subscribers);
+  }
+  auto cycleTime = Clock::now() - start;
+
+  long checksum = 0;
+  for (auto &subscriber : subscribers)
+  {
+    checksum += subscriber.sum;
+  }
+
+  if (checksum < 0)
+  {
+    std::printf("unexpected checksum\n");
+  }
+
+  return Result{name, slots, std::chrono::duration<double, std::nano>(invocationTime).count() / invocations,
+                std::chrono::duration<double, std::nano>(cycleTime).count() / cycles};
+}
+
+// adapts signals2 to the connect(callback, scope) used above
+struct Signals2Signal : boost::signals2::signal<void(const Message &)>
+{
+  template <typename TCallback>
+  boost::signals2::connection connect(TCallback callback, const void *)
+  {
+    return boost::signals2::signal<void(const Message &)>::connect(callback);
+  }
+};
+
+typedef smacc::SmaccLightSignal<void(const Message &)> LightSignal;
+typedef smacc::SmaccLightSignal<void(const Message &), std::mutex> SynchronizedLightSignal;
+} // namespace smacc_benchmark
+
+using namespace smacc_benchmark;
+
+int main(int argc, char **argv)
+{
+  unsigned long invocations = argc > 1 ? std::atol(argv[1]) : 10000000;
+  std::string outputFile = argc > 2 ? argv[2] : "";
+
+  std::vector<Result> results;
+  for (int slots : {1, 2, 8})
+  {
+    results.push_back(run<Signals2Signal>("boost_signals2", slots, invocations));
+    results.push_back(run<LightSignal>("light_signal", slots, invocations));
+    results.push_back(run<SynchronizedLightSignal>("light_signal_mutex", slots, invocations));
+  }
+
+  std::fprintf(stderr, "%-30s %6s %16s %22s\n", "signal", "slots", "invocation (ns)", "connect+disconnect (ns)");
+  for (auto &result : results)
+  {
+    std::fprintf(stderr, "%-30s %6d %16.2f %22.2f\n", result.signal.c_str(), result.slots, result.invocationNs,
+                 result.connectDisconnectNs);
+  }
+
+  FILE *out = outputFile.empty() ? stdout : std::fopen(outputFile.c_str(), "w");
+  if (out == nullptr)
+  {
+    std::fprintf(stderr, "cannot open %s\n", outputFile.c_str());
+    return 1;
+  }
+
+  std::fprintf(out, "{\n  \"invocations\": %lu,\n  \"results\": [\n", invocations);
+  for (std::size_t i = 0; i < results.size(); i++)
+  {
+    auto &result = results[i];
+    std::fprintf(out, "    {\"signal\": \"%s\", \"slots\": %d, \"invocation_ns\": %.3f, \"connect_disconnect_ns\": %.3f}%s\n",
+                 result.signal.c_str(), result.slots, result.invocationNs, result.connectDisconnectNs,
+                 i + 1 < results.size() ? "," : "");
+  }
+  std::fprintf(out, "  ]\n}\n");
+
+  if (out != stdout)
+  {
+    std::fclose(out);
+  }
+
+  return 0;
+}
@@ -0,0 +1,504 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+
+// Transition throughput benchmark of the smacc core, based on test/sm_coretest_transition_speed_1: each state posts
+// an event on its onEntry that makes the state machine transition to the next state. It is measured for three
+// state machine shapes:
+//
+//  - shallow:          two sibling states (the same as sm_coretest_transition_speed_1)
+//  - deep_nested:      two branches of DEEP_NESTING_DEPTH nested states (SmaccState with InnerInitial), every
+//                      transition exits a whole branch and enters the other one
+//  - many_orthogonals: two sibling states and MANY_ORTHOGONALS_COUNT orthogonals, each state configures one
+//                      client behavior per orthogonal
+//
+// For each one it reports the transitions/sec, the latency histogram from the postEvent call until the onEntry of
+// the next state and the heap allocations per transition of the state machine thread. The results are written as
+// json (stdout or the given file) so that they can be tracked for regressions.
+//
+// The state machines are the real smacc ones, so a ros master is required (ie: a local roscore).
+//
+// usage: smacc_transition_benchmark [measured_transitions] [warmup_transitions] [json_output_file]
+
+#include <smacc/smacc.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//--------------------------------------------------------------------
+// heap allocations counter
+namespace smacc_benchmark
+{
+std::atomic<unsigned long> allocationCount(0);
+
+// only the allocations of the state machine thread are counted
+thread_local bool countAllocations = false;
+} // namespace smacc_benchmark
+
+void *operator new(std::size_t size)
+{
+  if (smacc_benchmark::countAllocations)
+    smacc_benchmark::allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+  void *p = std::malloc(size == 0 ? 1 : size);
+  if (p == nullptr)
+    throw std::bad_alloc();
+  return p;
+}
+
+void *operator new[](std::size_t size)
+{
+  return ::operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+namespace smacc_benchmark
+{
+namespace mpl = boost::mpl;
+
+typedef std::chrono::steady_clock Clock;
+
+const int DEEP_NESTING_DEPTH = 4;
+const int MANY_ORTHOGONALS_COUNT = 8;
+
+struct BenchmarkResult
+{
+  std::string name;
+  unsigned long transitions;
+  double seconds;
+  std::vector<int64_t> latenciesNs;
+  unsigned long allocations;
+};
+
+// state of the running benchmark, it is only modified from the state machine thread (but the finished flag)
+struct BenchmarkRun
+{
+  unsigned long warmupTransitions;
+  unsigned long measuredTransitions;
+
+  unsigned long enteredStates;
+  Clock::time_point postTime;
+  Clock::time_point startTime;
+  Clock::time_point endTime;
+  unsigned long allocationsAtStart;
+  unsigned long allocationsAtEnd;
+  std::vector<int64_t> latenciesNs;
+
+  std::mutex mutex;
+  std::condition_variable finishedCondition;
+  bool finished;
+};
+
+BenchmarkRun *currentRun = nullptr;
+
+// called from the onEntry of the benchmark states, returns true if the next event has to be posted
+bool onStateEntered()
+{
+  auto now = Clock::now();
+  auto &run = *currentRun;
+  auto n = run.enteredStates++;
+
+  if (n == 0)
+  {
+    countAllocations = true;
+  }
+  else if (n > run.warmupTransitions)
+  {
+    // the latencies vector is reserved before running, push_back does not allocate
+    run.latenciesNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(now - run.postTime).count());
+  }
+
+  if (n == run.warmupTransitions)
+  {
+    run.startTime = now;
+    run.allocationsAtStart = allocationCount.load(std::memory_order_relaxed);
+  }
+  else if (n == run.warmupTransitions + run.measuredTransitions)
+  {
+    run.endTime = now;
+    run.allocationsAtEnd = allocationCount.load(std::memory_order_relaxed);
+    countAllocations = false;
+
+    std::lock_guard<std::mutex> lock(run.mutex);
+    run.finished = true;
+    run.finishedCondition.notify_one();
+    return false;
+  }
+
+  run.postTime = Clock::now();
+  return true;
+}
+
+struct EvBenchNext : sc::event<EvBenchNext, SmaccAllocator>
+{
+};
+
+//--------------------------------------------------------------------
+// shallow
+struct StShallowA;
+struct StShallowB;
+
+struct SmBenchShallow : smacc::SmaccStateMachineBase<SmBenchShallow, StShallowA>
+{
+  using SmaccStateMachineBase::SmaccStateMachineBase;
+};
+
+struct StShallowA : smacc::SmaccState<StShallowA, SmBenchShallow>
+{
+  using SmaccState::SmaccState;
+
+  typedef mpl::list<smacc::Transition<EvBenchNext, StShallowB>> reactions;
+
+  static void staticConfigure()
+  {
+  }
+
+  void onEntry()
+  {
+    if (onStateEntered())
+      this->postEvent<EvBenchNext>();
+  }
+};
+
+struct StShallowB : smacc::SmaccState<StShallowB, SmBenchShallow>
+{
+  using SmaccState::SmaccState;
+
+  typedef mpl::list<smacc::Transition<EvBenchNext, StShallowA>> reactions;
+
+  static void staticConfigure()
+  {
+  }
+
+  void onEntry()
+  {
+    if (onStateEntered())
+      this->postEvent<EvBenchNext>();
+  }
+};
+
+//--------------------------------------------------------------------
+// deep nested: StDeep<branch, DEEP_NESTING_DEPTH> is the outermost state of each branch, StDeep<branch, 0> the leaf.
+// The inner initial state is given as a list, otherwise checking if it is a sequence would instantiate the inner
+// template state before its context is complete
+template <int Branch, int Level>
+struct StDeep;
+
+struct SmBenchDeep : smacc::SmaccStateMachineBase<SmBenchDeep, StDeep<0, DEEP_NESTING_DEPTH>>
+{
+  using SmaccStateMachineBase::SmaccStateMachineBase;
+};
+
+template <int Branch, int Level>
+struct StDeep : smacc::SmaccState<StDeep<Branch, Level>,
+                                  typename std::conditional<Level == DEEP_NESTING_DEPTH, SmBenchDeep, StDeep<Branch, Level + 1>>::type,
+                                  typename std::conditional<Level == 0, mpl::list<>, mpl::list<StDeep<Branch, Level - 1>>>::type>
+{
+  typedef smacc::SmaccState<StDeep<Branch, Level>,
+                            typename std::conditional<Level == DEEP_NESTING_DEPTH, SmBenchDeep, StDeep<Branch, Level + 1>>::type,
+                            typename std::conditional<Level == 0, mpl::list<>, mpl::list<StDeep<Branch, Level - 1>>>::type>
+      TBase;
+
+  using TBase::TBase;
+
+  // only the leaf state reacts, going to the outermost state of the other branch
+  typedef typename std::conditional<Level == 0,
+                                    mpl::list<smacc::Transition<EvBenchNext, StDeep<1 - Branch, DEEP_NESTING_DEPTH>>>,
+                                    mpl::list<>>::type reactions;
+
+  static void staticConfigure()
+  {
+  }
+
+  void onEntry()
+  {
+    if (Level == 0 && onStateEntered())
+      this->template postEvent<EvBenchNext>();
+  }
+};
+
+//--------------------------------------------------------------------
+// many orthogonals
+template <int Index>
+class OrBench : public smacc::Orthogonal<OrBench<Index>>
+{
+public:
+  virtual void onInitialize() override
+  {
+  }
+};
+
+template <int Index>
+class CbBench : public smacc::SmaccClientBehavior
+{
+public:
+  virtual void onEntry() override
+  {
+  }
+};
+
+template <int Count>
+struct BenchOrthogonals
+{
+  template <typename TState>
+  static void configure()
+  {
+    BenchOrthogonals<Count - 1>::template configure<TState>();
+    TState::template configure_orthogonal<OrBench<Count>, CbBench<Count>>();
+  }
+};
+
+template <>
+struct BenchOrthogonals<0>
+{
+  template <typename TState>
+  static void configure()
+  {
+  }
+};
+
+struct StOrthogonalsA;
+struct StOrthogonalsB;
+
+struct SmBenchOrthogonals : smacc::SmaccStateMachineBase<SmBenchOrthogonals, StOrthogonalsA>
+{
+  using SmaccStateMachineBase::SmaccStateMachineBase;
+
+  virtual void onInitialize() override
+  {
+    this->createBenchOrthogonals(std::integral_constant<int, MANY_ORTHOGONALS_COUNT>());
+  }
+
+  template <int Count>
+  void createBenchOrthogonals(std::integral_constant<int, Count>)
+  {
+    this->createBenchOrthogonals(std::integral_constant<int, Count - 1>());
+    this->createOrthogonal<OrBench<Count>>();
+  }
+
+  void createBenchOrthogonals(std::integral_constant<int, 0>)
+  {
+  }
+};
+
+struct StOrthogonalsA : smacc::SmaccState<StOrthogonalsA, SmBenchOrthogonals>
+{
+  using SmaccState::SmaccState;
+
+  typedef mpl::list<smacc::Transition<EvBenchNext, StOrthogonalsB>> reactions;
+
+  static void staticConfigure()
+  {
+    BenchOrthogonals<MANY_ORTHOGONALS_COUNT>::configure<StOrthogonalsA>();
+  }
+
+  void onEntry()
+  {
+    if (onStateEntered())
+      this->postEvent<EvBenchNext>();
+  }
+};
+
+struct StOrthogonalsB : smacc::SmaccState<StOrthogonalsB, SmBenchOrthogonals>
+{
+  using SmaccState::SmaccState;
+
+  typedef mpl::list<smacc::Transition<EvBenchNext, StOrthogonalsA>> reactions;
+
+  static void staticConfigure()
+  {
+    BenchOrthogonals<MANY_ORTHOGONALS_COUNT>::configure<StOrthogonalsB>();
+  }
+
+  void onEntry()
+  {
+    if (onStateEntered())
+      this->postEvent<EvBenchNext>();
+  }
+};
+
+//--------------------------------------------------------------------
+// same as smacc::run, but without the signal detector polling loop and finishing after the measured transitions
+template <typename TStateMachine>
+BenchmarkResult runBenchmark(std::string name, unsigned long measuredTransitions, unsigned long warmupTransitions)
+{
+  BenchmarkRun run;
+  run.warmupTransitions = warmupTransitions;
+  run.measuredTransitions = measuredTransitions;
+  run.enteredStates = 0;
+  run.allocationsAtStart = 0;
+  run.allocationsAtEnd = 0;
+  run.latenciesNs.reserve(measuredTransitions);
+  run.finished = false;
+  currentRun = &run;
+
+  {
+    SmaccFifoScheduler scheduler(true);
+    smacc::SignalDetector signalDetector(&scheduler);
+
+    auto processor = scheduler.create_processor<TStateMachine>(&signalDetector);
+    signalDetector.setProcessorHandle(processor);
+    scheduler.initiate_processor(processor);
+
+    boost::thread stateMachineThread(boost::bind(&SmaccFifoScheduler::operator(), &scheduler, 0));
+
+    {
+      std::unique_lock<std::mutex> lock(run.mutex);
+      run.finishedCondition.wait(lock, [&] { return run.finished; });
+    }
+
+    scheduler.terminate();
+    stateMachineThread.join();
+  }
+
+  currentRun = nullptr;
+
+  BenchmarkResult result;
+  result.name = name;
+  result.transitions = measuredTransitions;
+  result.seconds = std::chrono::duration<double>(run.endTime - run.startTime).count();
+  result.latenciesNs = std::move(run.latenciesNs);
+  result.allocations = run.allocationsAtEnd - run.allocationsAtStart;
+  std::sort(result.latenciesNs.begin(), result.latenciesNs.end());
+  return result;
+}
+
+int64_t percentile(const std::vector<int64_t> &sortedValues, double p)
+{
+  if (sortedValues.empty())
+    return 0;
+  return sortedValues[std::min(sortedValues.size() - 1, (size_t)(p * sortedValues.size()))];
+}
+
+void writeJson(std::ostream &out, const std::vector<BenchmarkResult> &results)
+{
+  char date[64];
+  auto now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+  out << "{" << std::endl;
+  out << "  \"context\": {" << std::endl;
+  out << "    \"date\": \"" << date << "\"," << std::endl;
+  out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << "," << std::endl;
+#ifdef SMACC_LOCKFREE_EVENT_QUEUE
+  out << "    \"lockfree_event_queue\": true," << std::endl;
+#else
+  out << "    \"lockfree_event_queue\": false," << std::endl;
+#endif
+  out << "    \"tracing\": " << (SMACC_TRACING ? "true" : "false") << "," << std::endl;
+  out << "    \"deep_nesting_depth\": " << DEEP_NESTING_DEPTH << "," << std::endl;
+  out << "    \"many_orthogonals_count\": " << MANY_ORTHOGONALS_COUNT << std::endl;
+  out << "  }," << std::endl;
+  out << "  \"benchmarks\": [" << std::endl;
+
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    auto &result = results[i];
+    out << "    {" << std::endl;
+    out << "      \"name\": \"" << result.name << "\"," << std::endl;
+    out << "      \"transitions\": " << result.transitions << "," << std::endl;
+    out << "      \"real_time_s\": " << result.seconds << "," << std::endl;
+    out << "      \"transitions_per_second\": " << result.transitions / result.seconds << "," << std::endl;
+    out << "      \"allocations_per_transition\": " << (double)result.allocations / result.transitions << ","
+        << std::endl;
+    out << "      \"latency_ns\": {\"p50\": " << percentile(result.latenciesNs, 0.5)
+        << ", \"p90\": " << percentile(result.latenciesNs, 0.9)
+        << ", \"p99\": " << percentile(result.latenciesNs, 0.99)
+        << ", \"max\": " << (result.latenciesNs.empty() ? 0 : result.latenciesNs.back()) << "}," << std::endl;
+
+    // power of two buckets: [lower_ns, 2 * lower_ns)
+    std::vector<unsigned long> buckets(64, 0);
+    for (auto latency : result.latenciesNs)
+    {
+      int bucket = 0;
+      while (bucket < 63 && (int64_t(1) << (bucket + 1)) <= latency)
+        bucket++;
+      buckets[bucket]++;
+    }
+
+    out << "      \"latency_histogram\": [";
+    bool first = true;
+    for (int b = 0; b < 64; b++)
+    {
+      if (buckets[b] == 0)
+        continue;
+      out << (first ? "" : ", ") << "{\"lower_ns\": " << (int64_t(1) << b) << ", \"count\": " << buckets[b] << "}";
+      first = false;
+    }
+    out << "]" << std::endl;
+    out << "    }" << (i + 1 < results.size() ? "," : "") << std::endl;
+  }
+
+  out << "  ]" << std::endl;
+  out << "}" << std::endl;
+}
+} // namespace smacc_benchmark
+
+int main(int argc, char **argv)
+{
+  using namespace smacc_benchmark;
+  ros::init(argc, argv, "smacc_transition_benchmark");
+  ros::NodeHandle nh;
+
+  unsigned long measuredTransitions = argc > 1 ? std::atol(argv[1]) : 10000;
+  unsigned long warmupTransitions = argc > 2 ? std::atol(argv[2]) : 1000;
+  std::string outputFile = argc > 3 ? argv[3] : "";
+
+  std::vector<BenchmarkResult> results;
+  results.push_back(runBenchmark<SmBenchShallow>("shallow", measuredTransitions, warmupTransitions));
+  results.push_back(runBenchmark<SmBenchDeep>("deep_nested", measuredTransitions, warmupTransitions));
+  results.push_back(runBenchmark<SmBenchOrthogonals>("many_orthogonals", measuredTransitions, warmupTransitions));
+
+  for (auto &result : results)
+  {
+    fprintf(stderr, "%-18s transitions: %8lu  %12.0f transitions/sec  allocations/transition: %8.2f  latency p50: %9.2f us  p99: %9.2f us\n",
+            result.name.c_str(), result.transitions, result.transitions / result.seconds,
+            (double)result.allocations / result.transitions, percentile(result.latenciesNs, 0.5) / 1000.0,
+            percentile(result.latenciesNs, 0.99) / 1000.0);
+  }
+
+  if (outputFile.empty())
+  {
+    writeJson(std::cout, results);
+  }
+  else
+  {
+    std::ofstream out(outputFile);
+    writeJson(out, results);
+  }
+
+  return 0;
+}
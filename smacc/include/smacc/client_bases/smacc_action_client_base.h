@@ -83,7 +83,7 @@ public:
         auto *ev = new EvType();
         //ev->client = this;
         ev->resultMessage = *result;
-        ROS_INFO("Posting EVENT %s", demangleSymbol(typeid(ev).name()).c_str());
+        ROS_INFO("Posting EVENT %s", demangleType(typeid(ev)).c_str());
         this->postEvent(ev);
     }
 
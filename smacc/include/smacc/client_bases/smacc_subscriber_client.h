@@ -7,6 +7,7 @@
 #pragma once
 
 #include <smacc/smacc_client.h>
+#include <smacc/smacc_topic_event_policy.h>
 #include <boost/optional/optional_io.hpp>
 #include <smacc/impl/smacc_state_impl.h>
 
@@ -26,6 +27,7 @@ public:
   boost::optional<int> queueSize;
 
   typedef MessageType TMessageType;
+  typedef typename MessageType::ConstPtr TMessageConstPtr;
 
   SmaccSubscriberClient()
   {
@@ -40,13 +42,36 @@ public:
   virtual ~SmaccSubscriberClient()
   {
     sub_.shutdown();
+
+    auto statistics = eventBridge_.getStatistics();
+    if (statistics.conflated + statistics.decimated + statistics.signalOnly > 0)
+    {
+      ROS_INFO("[%s] topic events - received: %lu, posted: %lu, conflated: %lu, decimated: %lu, signal only: %lu",
+               this->getName().c_str(), statistics.received, statistics.posted, statistics.conflated,
+               statistics.decimated, statistics.signalOnly);
+    }
   }
 
+  // signals2 signals: invoked from the ros callback threads while the states connect and disconnect their slots
   smacc::SmaccSignal<void(const MessageType &)> onFirstMessageReceived_;
   smacc::SmaccSignal<void(const MessageType &)> onMessageReceived_;
 
-  std::function<void(const MessageType &)> postMessageEvent;
-  std::function<void(const MessageType &)> postInitialMessageEvent;
+  // the same notifications with the shared message, for the receivers that keep it (ie: in an event) without copying it
+  smacc::SmaccSignal<void(const TMessageConstPtr &)> onFirstMessagePtrReceived_;
+  smacc::SmaccSignal<void(const TMessageConstPtr &)> onMessagePtrReceived_;
+
+  std::function<void(const TMessageConstPtr &)> postInitialMessageEvent;
+
+  // how the messages are posted as EvTopicMessage events (ie: conflate a high rate topic). The signals are not affected
+  bool setEventPolicy(TopicEventPolicy policy, double rateHz = 0)
+  {
+    return eventBridge_.setPolicy(policy, rateHz);
+  }
+
+  TopicEventStatistics getEventStatistics() const
+  {
+    return eventBridge_.getStatistics();
+  }
 
   template <typename T>
   boost::signals2::connection onMessageReceived(void (T::*callback)(const MessageType &), T *object)
@@ -60,14 +85,27 @@ public:
     return this->getStateMachine()->createSignalConnection(onFirstMessageReceived_, callback, object);
   }
 
+  template <typename T>
+  boost::signals2::connection onMessagePtrReceived(void (T::*callback)(const TMessageConstPtr &), T *object)
+  {
+    return this->getStateMachine()->createSignalConnection(onMessagePtrReceived_, callback, object);
+  }
+
+  template <typename T>
+  boost::signals2::connection onFirstMessagePtrReceived(void (T::*callback)(const TMessageConstPtr &), T *object)
+  {
+    return this->getStateMachine()->createSignalConnection(onFirstMessagePtrReceived_, callback, object);
+  }
+
   template <typename TOrthogonal, typename TSourceObject>
   void onOrthogonalAllocation()
   {
-    this->postMessageEvent = [=](auto msg) {
+    this->eventBridge_.setPostFunction([=](const TMessageConstPtr &msg, std::shared_ptr<void> token) {
       auto event = new EvTopicMessage<TSourceObject, TOrthogonal>();
       event->msgData = msg;
+      event->conflationToken = std::move(token);
       this->postEvent(event);
-    };
+    });
 
     this->postInitialMessageEvent = [=](auto msg) {
       auto event = new EvTopicInitialMessage<TSourceObject, TOrthogonal>();
@@ -107,17 +145,22 @@ private:
   bool firstMessage_;
   bool initialized_;
 
-  void messageCallback(const MessageType &msg)
+  TopicEventBridge<TMessageConstPtr> eventBridge_;
+
+  // the message is received as a shared pointer and it is not copied for the signals nor the events
+  void messageCallback(const TMessageConstPtr &msg)
   {
     if (firstMessage_)
     {
       postInitialMessageEvent(msg);
-      onFirstMessageReceived_(msg);
+      onFirstMessageReceived_(*msg);
+      onFirstMessagePtrReceived_(msg);
       firstMessage_ = false;
     }
 
-    onMessageReceived_(msg);
-    postMessageEvent(msg);
+    onMessageReceived_(*msg);
+    onMessagePtrReceived_(msg);
+    eventBridge_.onMessage(msg);
   }
 };
 } // namespace client_bases
@@ -27,17 +27,18 @@
 //#include <actionlib/client/simple_action_client.h>
 
 #include <smacc/smacc_fifo_scheduler.h>
+#include <smacc/smacc_tracing.h>
 #include <smacc/smacc_types.h>
 #include <smacc/introspection/introspection.h>
 
-typedef boost::statechart::processor_container<boost::statechart::fifo_scheduler<>, boost::function0<void>, std::allocator<void>>::processor_context my_context;
+typedef SmaccFifoScheduler::processor_context my_context;
 namespace smacc
 {
 
 namespace utils
 {
-// demangles the type name to be used as a node handle path
-std::string cleanShortTypeName(const std::type_info &tinfo);
+// demangles the type name to be used as a node handle path (cached, the reference is valid until the process ends)
+const std::string &cleanShortTypeName(const std::type_info &tinfo);
 } // namespace utils
 
 enum class SMRunMode
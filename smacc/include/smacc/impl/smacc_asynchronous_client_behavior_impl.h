@@ -14,17 +14,27 @@ namespace smacc
     template <typename TOrthogonal, typename TSourceObject>
     void SmaccAsyncClientBehavior::onOrthogonalAllocation()
     {
+        // once the owner state is leaving (cancelled) its events are not relevant anymore
         postFinishEventFn_ = [=] {
+            if (this->isCancelled())
+                return;
+
             this->onFinished_();
             this->postEvent<EvCbFinished<TSourceObject, TOrthogonal>>();
         };
 
         postSuccessEventFn_ = [=] {
+            if (this->isCancelled())
+                return;
+
             this->onSuccess_();
             this->postEvent<EvCbSuccess<TSourceObject, TOrthogonal>>();
         };
 
         postFailureEventFn_ = [=] {
+            if (this->isCancelled())
+                return;
+
             this->onFailure_();
             this->postEvent<EvCbFailure<TSourceObject, TOrthogonal>>();
         };
@@ -32,6 +32,13 @@ namespace smacc
     template <typename TComponent>
     TComponent *ISmaccClient::getComponent(std::string name)
     {
+        auto *indexedComponent = componentIndex_.find<TComponent>(name);
+        if (indexedComponent != nullptr)
+        {
+            return indexedComponent;
+        }
+
+        // TComponent may be a base class of the component type
         for (auto &component : components_)
         {
             if (component.first.name != name)
@@ -73,6 +80,26 @@ namespace smacc
             ret->initialize(this);
 
             this->components_[componentkey] = ret; //std::dynamic_pointer_cast<smacc::ISmaccComponent>(ret);
+            this->componentIndex_.add<SmaccComponentType>(ret.get(), name);
+
+            // ISmaccStateMachine::requiresComponent only resolves unnamed components
+            if (name.empty())
+            {
+                // the client is added to the orthogonal after its allocation, where it usually creates the components
+                std::size_t clientIndex = 0;
+                if (this->orthogonal_ != nullptr)
+                {
+                    auto &clients = this->orthogonal_->getClients();
+                    clientIndex = std::find_if(clients.begin(), clients.end(),
+                                               [this](const std::shared_ptr<ISmaccClient> &client) { return client.get() == this; }) -
+                                  clients.begin();
+                }
+
+                this->getStateMachine()->template registerComponent<SmaccComponentType>(
+                    ret.get(), demangledTypeName<TOrthogonal>(), clientIndex);
+            }
+
+            this->getStateMachine()->registerUpdatableClient(asUpdatable(ret.get()));
             ROS_DEBUG("%s resource is required. Done.", tname.c_str());
         }
         else
@@ -15,6 +15,11 @@ namespace smacc
 template <typename SmaccClientType>
 bool ISmaccOrthogonal::requiresClient(SmaccClientType *&storage)
 {
+    storage = clientIndex_.find<SmaccClientType>();
+    if (storage != nullptr)
+        return true;
+
+    // SmaccClientType may be a base class of the client type
     for (auto &client : clients_)
     {
         storage = dynamic_cast<SmaccClientType *>(client.get());
@@ -25,6 +30,13 @@ bool ISmaccOrthogonal::requiresClient(SmaccClientType *&storage)
     auto requiredClientName = demangledTypeName<SmaccClientType>();
     ROS_WARN_STREAM("Required client ["<< requiredClientName<< "] not found in current orthogonal. Searching in other orthogonals.");
 
+    storage = this->getStateMachine()->template findClient<SmaccClientType>();
+    if (storage != nullptr)
+    {
+        ROS_WARN_STREAM("Required client  ["<< requiredClientName<<"] found in other orthogonal.");
+        return true;
+    }
+
     for (auto &orthoentry : this->getStateMachine()->getOrthogonals())
     {
         for (auto &client : orthoentry.second->getClients())
@@ -162,6 +174,10 @@ public:
 
         // it is stored the client (not the client handler)
         clients_.push_back(client);
+        clientIndex_.add<TClient>(client.get());
+        this->getStateMachine()->template registerClient<TClient>(client.get(), demangledTypeName<TOrthogonal>(),
+                                                                  clients_.size() - 1);
+        this->getStateMachine()->registerUpdatableClient(asUpdatable(client.get()));
 
         return client;
     }
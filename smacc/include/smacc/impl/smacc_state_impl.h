@@ -43,12 +43,11 @@ namespace smacc
     }
     //-------------------------------------------------------------------------------------------------------
 
-#define THIS_STATE_NAME ((demangleSymbol(typeid(*this).name()).c_str()))
+#define THIS_STATE_NAME ((demangleType(typeid(*this)).c_str()))
     template <typename TOrthogonal, typename TBehavior, typename... Args>
     std::shared_ptr<TBehavior> ISmaccState::configure(Args &&... args)
     {
-        std::string orthogonalkey = demangledTypeName<TOrthogonal>();
-        ROS_INFO("[%s] Configuring orthogonal: %s", THIS_STATE_NAME, orthogonalkey.c_str());
+        ROS_INFO("[%s] Configuring orthogonal: %s", THIS_STATE_NAME, demangledTypeName<TOrthogonal>().c_str());
 
         TOrthogonal *orthogonal = this->getOrthogonal<TOrthogonal>();
         if (orthogonal != nullptr)
@@ -56,12 +55,13 @@ namespace smacc
             auto clientBehavior = std::shared_ptr<TBehavior>(new TBehavior(args...));
             clientBehavior->currentState = this;
             orthogonal->addClientBehavior(clientBehavior);
+            this->getStateMachine().registerUpdatableStateElement(asUpdatable(clientBehavior.get()), nullptr);
             clientBehavior->template onOrthogonalAllocation<TOrthogonal, TBehavior>();
             return clientBehavior;
         }
         else
         {
-            ROS_ERROR("[%s] Skipping client behavior creation in orthogonal [%s]. It does not exist.", THIS_STATE_NAME, orthogonalkey.c_str());
+            ROS_ERROR("[%s] Skipping client behavior creation in orthogonal [%s]. It does not exist.", THIS_STATE_NAME, demangledTypeName<TOrthogonal>().c_str());
             return nullptr;
         }
     }
@@ -77,8 +77,12 @@ namespace smacc
     template <typename SmaccClientType>
     void ISmaccState::requiresClient(SmaccClientType *&storage)
     {
-        const char *sname = (demangleSymbol(typeid(*this).name()).c_str());
-        storage = nullptr;
+        storage = this->getStateMachine().template findClient<SmaccClientType>();
+        if (storage != nullptr)
+            return;
+
+        // SmaccClientType may be a base class of the client type
+        const char *sname = demangleType(typeid(*this)).c_str();
         auto &orthogonals = this->getStateMachine().getOrthogonals();
         for (auto &ortho : orthogonals)
         {
@@ -113,6 +117,7 @@ namespace smacc
         //sb->initialize(this, mock);
         //sb->setOutputEvent(typelist<TTriggerEvent>());
         stateReactors_.push_back(sr);
+        this->getStateMachine().registerUpdatableStateElement(asUpdatable(sr.get()), this);
         return sr;
     }
 
@@ -121,6 +126,7 @@ namespace smacc
     {
         auto eg = std::make_shared<TEventGenerator>(args...);
         eventGenerators_.push_back(eg);
+        this->getStateMachine().registerUpdatableStateElement(asUpdatable(eg.get()), this);
         return eg;
     }
 
@@ -153,6 +159,7 @@ namespace smacc
         boost::mpl::for_each<wrappedList>(op);
 
         stateReactors_.push_back(sr);
+        this->getStateMachine().registerUpdatableStateElement(asUpdatable(sr.get()), this);
         return sr;
     }
     
@@ -29,23 +29,18 @@ namespace smacc
   template <typename TOrthogonal>
   TOrthogonal *ISmaccStateMachine::getOrthogonal()
   {
-    std::lock_guard<std::recursive_mutex> lock(m_mutex_);
+    auto index = getTypeIndex<ISmaccOrthogonal, TOrthogonal>();
+    auto *table = orthogonalTable_.load(std::memory_order_acquire);
 
-    std::string orthogonalkey = demangledTypeName<TOrthogonal>();
-    TOrthogonal *ret;
-
-    auto it = orthogonals_.find(orthogonalkey);
-
-    if (it != orthogonals_.end())
+    if (table != nullptr && index < table->size() && (*table)[index] != nullptr)
     {
-      ROS_DEBUG("Orthogonal %s resource is being required from some state, client or component. Found resource in cache.", orthogonalkey.c_str());
-      ret = dynamic_cast<TOrthogonal *>(it->second.get());
-      return ret;
+      return static_cast<TOrthogonal *>((*table)[index]);
     }
     else
     {
+      ProfiledLockGuard<std::recursive_mutex> lock(structureMutex_, SMACC_LOCK_SITE("ISmaccStateMachine::getOrthogonal"));
       std::stringstream ss;
-      ss << "Orthogonal not found " << orthogonalkey.c_str() << std::endl;
+      ss << "Orthogonal not found " << demangledTypeName<TOrthogonal>() << std::endl;
       ss << "The existing orthogonals are the following: " << std::endl;
       for (auto &orthogonal : orthogonals_)
       {
@@ -62,7 +57,7 @@ namespace smacc
   template <typename TOrthogonal>
   void ISmaccStateMachine::createOrthogonal()
   {
-    this->lockStateMachine("create orthogonal");
+    ProfiledLockGuard<std::recursive_mutex> lock(structureMutex_, SMACC_LOCK_SITE("ISmaccStateMachine::createOrthogonal"));
     std::string orthogonalkey = demangledTypeName<TOrthogonal>();
 
     if (orthogonals_.count(orthogonalkey) == 0)
@@ -70,6 +65,19 @@ namespace smacc
       auto ret = std::make_shared<TOrthogonal>();
       orthogonals_[orthogonalkey] = dynamic_pointer_cast<smacc::ISmaccOrthogonal>(ret);
 
+      // publish a new version of the orthogonal table including the new one
+      auto index = getTypeIndex<ISmaccOrthogonal, TOrthogonal>();
+      auto *currentTable = orthogonalTable_.load(std::memory_order_relaxed);
+      std::unique_ptr<std::vector<ISmaccOrthogonal *>> table(
+          currentTable != nullptr ? new std::vector<ISmaccOrthogonal *>(*currentTable) : new std::vector<ISmaccOrthogonal *>());
+
+      if (table->size() <= index)
+        table->resize(index + 1, nullptr);
+
+      (*table)[index] = ret.get();
+      orthogonalTable_.store(table.get(), std::memory_order_release);
+      orthogonalTableVersions_.push_back(std::move(table));
+
       ret->setStateMachine(this);
 
       ROS_INFO("%s Orthogonal is created", orthogonalkey.c_str());
@@ -86,16 +94,44 @@ namespace smacc
       }
       ROS_WARN_STREAM(ss.str());
     }
-    this->unlockStateMachine("create orthogonal");
   }
 
   //-------------------------------------------------------------------------------------------------------
+  template <typename TClient>
+  void ISmaccStateMachine::registerClient(TClient *client, const std::string &orthogonalKey, std::size_t clientIndex)
+  {
+    ProfiledLockGuard<std::recursive_mutex> lock(structureMutex_, SMACC_LOCK_SITE("ISmaccStateMachine::registerClient"));
+    clientRegistry_.add<TClient>(client, std::string(), std::make_pair(orthogonalKey, clientIndex));
+  }
+
+  template <typename TComponent>
+  void ISmaccStateMachine::registerComponent(TComponent *component, const std::string &orthogonalKey,
+                                             std::size_t clientIndex)
+  {
+    ProfiledLockGuard<std::recursive_mutex> lock(structureMutex_, SMACC_LOCK_SITE("ISmaccStateMachine::registerComponent"));
+    componentRegistry_.add<TComponent>(component, std::string(), std::make_pair(orthogonalKey, clientIndex));
+  }
+
+  template <typename TClient>
+  TClient *ISmaccStateMachine::findClient()
+  {
+    ProfiledLockGuard<std::recursive_mutex> lock(structureMutex_, SMACC_LOCK_SITE("ISmaccStateMachine::findClient"));
+    return clientRegistry_.find<TClient>();
+  }
+
   template <typename SmaccComponentType>
   void ISmaccStateMachine::requiresComponent(SmaccComponentType *&storage)
   {
-    ROS_DEBUG("component %s is required", demangleSymbol(typeid(SmaccComponentType).name()).c_str());
-    std::lock_guard<std::recursive_mutex> lock(m_mutex_);
+    ROS_DEBUG("component %s is required", demangleType(typeid(SmaccComponentType)).c_str());
+    ProfiledLockGuard<std::recursive_mutex> lock(structureMutex_, SMACC_LOCK_SITE("ISmaccStateMachine::requiresComponent"));
+
+    storage = componentRegistry_.find<SmaccComponentType>();
+    if (storage != nullptr)
+    {
+      return;
+    }
 
+    // SmaccComponentType may be a base class of the component type
     for (auto ortho : this->orthogonals_)
     {
       for (auto &client : ortho.second->clients_)
@@ -109,7 +145,7 @@ namespace smacc
       }
     }
 
-    ROS_WARN("component %s is required but it was not found in any orthogonal", demangleSymbol(typeid(SmaccComponentType).name()).c_str());
+    ROS_WARN("component %s is required but it was not found in any orthogonal", demangleType(typeid(SmaccComponentType)).c_str());
 
     // std::string componentkey = demangledTypeName<SmaccComponentType>();
     // SmaccComponentType *ret;
@@ -137,29 +173,30 @@ namespace smacc
   template <typename EventType>
   void ISmaccStateMachine::postEvent(EventType *ev, EventLifeTime evlifetime)
   {
-    std::lock_guard<std::recursive_mutex> guard(eventQueueMutex_);
-    if (evlifetime == EventLifeTime::CURRENT_STATE && (stateMachineCurrentAction == StateMachineInternalAction::STATE_EXITING ||
-                                                       stateMachineCurrentAction == StateMachineInternalAction::TRANSITIONING))
+    // owns the event until it is queued, also when the transition finishes before it can be deferred
+    DeferredEventQueue::EventPtr event(ev);
+
+    // read before the transition check: if the state changes meanwhile the event is tagged with the exited state
+    auto state = this->getCurrentStateCounter();
+    if (evlifetime == EventLifeTime::CURRENT_STATE && this->isTransitioning())
     {
-      ROS_WARN_STREAM("CURRENT STATE SCOPED EVENT SKIPPED, state is exiting/transitioning " << demangleSymbol<EventType>());
-      return;
-      // in this case we may lose/skip events, if this is not right for some cases we should create a queue
-      // to lock the events during the transitions. This issues appeared when a client asyncbehavior was posting an event
-      // meanwhile we were doing the transition, but the main thread was waiting for its correct finalization (with thread.join)
+      // This issue appeared when a client asyncbehavior was posting an event meanwhile we were doing the transition,
+      // but the main thread was waiting for its correct finalization (with thread.join). The event is held until the
+      // next state is steady (see DeferredEventQueue)
+      if (deferredEvents_->defer(event, state, [this]() { return this->isTransitioning(); }))
+      {
+        SMACC_TRACE_DEBUG_STREAM("[PostEvent] current state scoped event deferred, state is exiting/transitioning " << demangleSymbol<EventType>());
+        return;
+      }
     }
 
     // when a postting event is requested by any component, client, or client behavior
-    // we reach this place. Now, we propagate the events to all the state state reactors to generate
-    // some more events
+    // we reach this place. The event is queued and the state machine thread notifies it to the state reactors
+    // just before processing it (notifyStateReactors), so this does not need any lock
 
-    ROS_DEBUG_STREAM("[PostEvent entry point] " << demangleSymbol<EventType>());
-    auto currentstate = currentState_;
-    if (currentstate != nullptr)
-    {
-      propagateEventToStateReactors(currentstate, ev);
-    }
+    SMACC_TRACE_DEBUG_STREAM("[PostEvent entry point] " << demangleSymbol<EventType>());
 
-    this->signalDetector_->postEvent(ev);
+    this->signalDetector_->postEvent(event);
   }
 
   template <typename EventType>
@@ -172,62 +209,65 @@ namespace smacc
   template <typename T>
   bool ISmaccStateMachine::getGlobalSMData(std::string name, T &ret)
   {
-    std::lock_guard<std::recursive_mutex> lock(m_mutex_);
-    // ROS_WARN("get SM Data lock acquire");
-    bool success = false;
-
-    if (!globalData_.count(name))
+    int index = globalData_.find(name);
+    if (index < 0)
     {
-      // ROS_WARN("get SM Data - data do not exist");
-      success = false;
+      return false;
     }
-    else
+
+    auto record = std::atomic_load(&globalData_.getSlot(index)->record);
+    if (record == nullptr)
     {
-      // ROS_WARN("get SM DAta -data exist. accessing");
-      try
-      {
-        auto &v = globalData_[name];
+      return false;
+    }
 
-        // ROS_WARN("get SM DAta -data exist. any cast");
-        ret = boost::any_cast<T>(v.second);
-        success = true;
-        // ROS_WARN("get SM DAta -data exist. success");
-      }
-      catch (boost::bad_any_cast &ex)
-      {
-        ROS_ERROR("bad any cast: %s", ex.what());
-        success = false;
-      }
+    if (*record->type != typeid(T))
+    {
+      ROS_ERROR("bad global data type: '%s' is a %s, not a %s", name.c_str(), demangleType(*record->type).c_str(),
+                demangleType(typeid(T)).c_str());
+      return false;
     }
 
-    // ROS_WARN("get SM Data lock release");
-    return success;
+    ret = static_cast<const TypedGlobalDataRecord<T> &>(*record).value;
+    return true;
   }
 
   template <typename T>
   void ISmaccStateMachine::setGlobalSMData(std::string name, T value)
   {
-    {
-      std::lock_guard<std::recursive_mutex> lock(m_mutex_);
-      // ROS_WARN("set SM Data lock acquire");
-
-      globalData_[name] = {[this, name]() {
-                             std::stringstream ss;
-                             auto val = any_cast<T>(globalData_[name].second);
-                             ss << val;
-                             return ss.str();
-                           },
-                           value};
-    }
+    globalData_.set(globalData_.getKey<T>(name), std::move(value));
+  }
 
-    this->updateStatusMessage();
+  template <typename T>
+  GlobalDataKey<T> ISmaccStateMachine::getGlobalDataKey(std::string name)
+  {
+    return globalData_.getKey<T>(name);
+  }
+
+  template <typename T>
+  std::shared_ptr<const T> ISmaccStateMachine::getGlobalSMData(const GlobalDataKey<T> &key)
+  {
+    return globalData_.get(key);
+  }
+
+  template <typename T>
+  void ISmaccStateMachine::setGlobalSMData(const GlobalDataKey<T> &key, T value)
+  {
+    globalData_.set(key, std::move(value));
+  }
+
+  template <typename T>
+  boost::signals2::connection ISmaccStateMachine::onGlobalSMDataChanged(const GlobalDataKey<T> &key,
+                                                                        std::function<void(const T &)> callback)
+  {
+    return globalData_.onChanged(key, callback);
   }
 
   template <typename StateField, typename BehaviorType>
   void ISmaccStateMachine::mapBehavior()
   {
-    std::string stateFieldName = demangleSymbol(typeid(StateField).name());
-    std::string behaviorType = demangleSymbol(typeid(BehaviorType).name());
+    std::string stateFieldName = demangleType(typeid(StateField));
+    std::string behaviorType = demangleType(typeid(BehaviorType));
     ROS_INFO("Mapping state field '%s' to stateReactor '%s'", stateFieldName.c_str(), behaviorType.c_str());
     SmaccClientBehavior *globalreference;
     if (!this->getGlobalSMData(stateFieldName, globalreference))
@@ -248,15 +288,14 @@ namespace smacc
     struct Bind
     {
       template <typename TSmaccSignal, typename TMemberFunctionPrototype, typename TSmaccObjectType>
-      boost::signals2::connection bindaux(TSmaccSignal &signal, TMemberFunctionPrototype callback,
-                                          TSmaccObjectType *object);
+      auto bindaux(TSmaccSignal &signal, TMemberFunctionPrototype callback, TSmaccObjectType *object);
     };
 
     template <>
     struct Bind<1>
     {
       template <typename TSmaccSignal, typename TMemberFunctionPrototype, typename TSmaccObjectType>
-      boost::signals2::connection bindaux(TSmaccSignal &signal, TMemberFunctionPrototype callback, TSmaccObjectType *object)
+      auto bindaux(TSmaccSignal &signal, TMemberFunctionPrototype callback, TSmaccObjectType *object)
       {
         return signal.connect([=]() { return (object->*callback)(); });
       }
@@ -266,7 +305,7 @@ namespace smacc
     struct Bind<2>
     {
       template <typename TSmaccSignal, typename TMemberFunctionPrototype, typename TSmaccObjectType>
-      boost::signals2::connection bindaux(TSmaccSignal &signal, TMemberFunctionPrototype callback, TSmaccObjectType *object)
+      auto bindaux(TSmaccSignal &signal, TMemberFunctionPrototype callback, TSmaccObjectType *object)
       {
         return signal.connect([=](auto a1) { return (object->*callback)(a1); });
       }
@@ -276,7 +315,7 @@ namespace smacc
     struct Bind<3>
     {
       template <typename TSmaccSignal, typename TMemberFunctionPrototype, typename TSmaccObjectType>
-      boost::signals2::connection bindaux(TSmaccSignal &signal, TMemberFunctionPrototype callback, TSmaccObjectType *object)
+      auto bindaux(TSmaccSignal &signal, TMemberFunctionPrototype callback, TSmaccObjectType *object)
       {
         return signal.connect([=](auto a1, auto a2) { return (object->*callback)(a1, a2); });
       }
@@ -286,7 +325,7 @@ namespace smacc
     struct Bind<4>
     {
       template <typename TSmaccSignal, typename TMemberFunctionPrototype, typename TSmaccObjectType>
-      boost::signals2::connection bindaux(TSmaccSignal &signal, TMemberFunctionPrototype callback, TSmaccObjectType *object)
+      auto bindaux(TSmaccSignal &signal, TMemberFunctionPrototype callback, TSmaccObjectType *object)
       {
         return signal.connect([=](auto a1, auto a2, auto a3) { return (object->*callback)(a1, a2, a3); });
       }
@@ -295,9 +334,9 @@ namespace smacc
   using namespace smacc::utils;
 
   template <typename TSmaccSignal, typename TMemberFunctionPrototype, typename TSmaccObjectType>
-  boost::signals2::connection ISmaccStateMachine::createSignalConnection(TSmaccSignal &signal,
-                                                                         TMemberFunctionPrototype callback,
-                                                                         TSmaccObjectType *object)
+  SignalConnection<TSmaccSignal> ISmaccStateMachine::createSignalConnection(TSmaccSignal &signal,
+                                                                            TMemberFunctionPrototype callback,
+                                                                            TSmaccObjectType *object)
   {
     static_assert(std::is_base_of<ISmaccState, TSmaccObjectType>::value ||
                       std::is_base_of<ISmaccClient, TSmaccObjectType>::value ||
@@ -308,7 +347,7 @@ namespace smacc
 
     typedef decltype(callback) ft;
     Bind<boost::function_types::function_arity<ft>::value> binder;
-    boost::signals2::connection connection = binder.bindaux(signal, callback, object);
+    SignalConnection<TSmaccSignal> connection = binder.bindaux(signal, callback, object);
 
     // long life-time objects
     if (std::is_base_of<ISmaccComponent, TSmaccObjectType>::value ||
@@ -323,7 +362,7 @@ namespace smacc
     {
       ROS_INFO("[StateMachine] life-time constrained smacc signal subscription created. Subscriber is %s",
                demangledTypeName<TSmaccObjectType>().c_str());
-      stateCallbackConnections.push_back(connection);
+      this->addStateCallbackConnection(connection);
     }
     else // state life-time objects
     {
@@ -365,39 +404,29 @@ namespace smacc
   template <typename StateType>
   void ISmaccStateMachine::notifyOnStateEntryStart(StateType *state)
   {
-    std::lock_guard<std::recursive_mutex> lock(m_mutex_);
+    ProfiledLockGuard<std::recursive_mutex> lock(updateMutex_, SMACC_LOCK_SITE("ISmaccStateMachine::notifyOnStateEntryStart"));
 
-    ROS_DEBUG("[State Machne] Initializating a new state '%s' and updating current state. Getting state meta-information. number of orthogonals: %ld", demangleSymbol(typeid(StateType).name()).c_str(), this->orthogonals_.size());
+    SMACC_TRACE_DEBUG("[State Machne] Initializating a new state '%s' and updating current state. Getting state meta-information. number of orthogonals: %ld", demangleType(typeid(StateType)).c_str(), this->orthogonals_.size());
 
     stateSeqCounter_++;
     currentState_ = state;
     currentStateInfo_ = stateMachineInfo_->getState<StateType>();
+    currentStateIndex_ = currentStateInfo_ != nullptr ? currentStateInfo_->stateIndex_ : -1;
+
+    this->registerUpdatableStateElement(asUpdatable(state), state);
+    this->refreshStateReactorDispatchTable();
   }
 
   template <typename StateType>
   void ISmaccStateMachine::notifyOnStateEntryEnd(StateType *state)
   {
-    ROS_INFO("[%s] State OnEntry code finished", demangleSymbol(typeid(StateType).name()).c_str());
+    SMACC_TRACE_INFO("[%s] State OnEntry code finished", demangleType(typeid(StateType)).c_str());
 
-    for (auto pair : this->orthogonals_)
-    {
-      //ROS_INFO("ortho onentry: %s", pair.second->getName().c_str());
-      auto &orthogonal = pair.second;
-      try
-      {
-        orthogonal->onEntry();
-      }
-      catch (const std::exception &e)
-      {
-        ROS_ERROR("[Orthogonal %s] Exception on Entry - continuing with next orthogonal. Exception info: %s",
-                  pair.second->getName().c_str(), e.what());
-      }
-    }
+    this->executeOrthogonals(true);
 
     for (auto &sr : this->currentState_->getStateReactors())
     {
-      auto srname = smacc::demangleSymbol(typeid(*sr).name()).c_str();
-      ROS_INFO("state reactor onEntry: %s", srname);
+      SMACC_TRACE_INFO("state reactor onEntry: %s", demangleType(typeid(*sr)).c_str());
       try
       {
         sr->onEntry();
@@ -405,14 +434,13 @@ namespace smacc
       catch (const std::exception &e)
       {
         ROS_ERROR("[State Reactor %s] Exception on Entry - continuing with next state reactor. Exception info: %s",
-                  srname, e.what());
+                  demangleType(typeid(*sr)).c_str(), e.what());
       }
     }
 
     for (auto &eg : this->currentState_->getEventGenerators())
     {
-      auto egname = smacc::demangleSymbol(typeid(*eg).name()).c_str();
-      ROS_INFO("state reactor onEntry: %s", egname);
+      SMACC_TRACE_INFO("event generator onEntry: %s", demangleType(typeid(*eg)).c_str());
       try
       {
         eg->onEntry();
@@ -420,12 +448,18 @@ namespace smacc
       catch (const std::exception &e)
       {
         ROS_ERROR("[Event generator %s] Exception on Entry - continuing with next state reactor. Exception info: %s",
-                  egname, e.what());
+                  demangleType(typeid(*eg)).c_str(), e.what());
       }
     }
 
+    this->refreshStateReactorDispatchTable();
     this->updateStatusMessage();
     stateMachineCurrentAction = StateMachineInternalAction::STATE_STEADY;
+
+    this->flushDeferredEvents();
+
+    // the updatable elements of the new state are refreshed without waiting for the current update deadline
+    this->signalDetector_->wakeUp();
   }
 
   template <typename StateType>
@@ -438,6 +472,8 @@ namespace smacc
       orthogonal->runtimeConfigure();
     }
 
+    // the static and runtime configured state reactors are already created
+    this->refreshStateReactorDispatchTable();
     this->updateStatusMessage();
 
     stateMachineCurrentAction = StateMachineInternalAction::STATE_ENTERING;
@@ -454,29 +490,18 @@ namespace smacc
   {
     stateMachineCurrentAction = StateMachineInternalAction::STATE_EXITING;
 
-    auto fullname = demangleSymbol(typeid(StateType).name());
-    ROS_WARN_STREAM("exiting state: " << fullname);
+    SMACC_TRACE_INFO("exiting state: %s", demangleType(typeid(StateType)).c_str());
     //this->setParam("destroyed", true);
 
-    ROS_INFO_STREAM("Notification State Exit: leaving state" << state);
-    for (auto pair : this->orthogonals_)
-    {
-      auto &orthogonal = pair.second;
-      try
-      {
-        orthogonal->onExit();
-      }
-      catch (const std::exception &e)
-      {
-        ROS_ERROR("[Orthogonal %s] Exception onExit - continuing with next orthogonal. Exception info: %s",
-                  pair.second->getName().c_str(), e.what());
-      }
-    }
+    SMACC_TRACE_INFO_STREAM("Notification State Exit: leaving state" << state);
+
+    // the state, its state reactors and its event generators are not updated anymore (they are going to be destroyed)
+    this->signalDetector_->unregisterUpdatableStateElements(state);
+    this->executeOrthogonals(false);
 
     for (auto &sr : state->getStateReactors())
     {
-      auto srname = smacc::demangleSymbol(typeid(*sr).name()).c_str();
-      ROS_INFO("state reactor OnExit: %s", srname);
+      SMACC_TRACE_INFO("state reactor OnExit: %s", demangleType(typeid(*sr)).c_str());
       try
       {
         sr->onExit();
@@ -484,66 +509,59 @@ namespace smacc
       catch (const std::exception &e)
       {
         ROS_ERROR("[State Reactor %s] Exception on OnExit - continuing with next state reactor. Exception info: %s",
-                  srname, e.what());
+                  demangleType(typeid(*sr)).c_str(), e.what());
       }
     }
 
     for (auto &eg : state->getEventGenerators())
     {
-      auto egname = smacc::demangleSymbol(typeid(*eg).name()).c_str();
-      ROS_INFO("state reactor OnExit: %s", egname);
+      SMACC_TRACE_INFO("event generator OnExit: %s", demangleType(typeid(*eg)).c_str());
       try
       {
         eg->onExit();
       }
       catch (const std::exception &e)
       {
-        ROS_ERROR("[State Reactor %s] Exception on OnExit - continuing with next state reactor. Exception info: %s",
-                  egname, e.what());
+        ROS_ERROR("[Event generator %s] Exception on OnExit - continuing with next event generator. Exception info: %s",
+                  demangleType(typeid(*eg)).c_str(), e.what());
       }
     }
 
-    this->lockStateMachine("state exit");
+    this->lockStateMachine(SMACC_LOCK_SITE("ISmaccStateMachine::notifyOnStateExitting"));
 
-    for (auto &conn : this->stateCallbackConnections)
     {
-      ROS_WARN_STREAM("[StateMachine] Disconnecting scoped-lifetime SmaccSignal subscription");
-      conn.disconnect();
-    }
+      ProfiledLockGuard<std::mutex> lock(stateCallbackConnectionsMutex_, SMACC_LOCK_SITE("ISmaccStateMachine::notifyOnStateExitting"));
+      for (auto &conn : this->stateCallbackConnections)
+      {
+        SMACC_TRACE_INFO("[StateMachine] Disconnecting scoped-lifetime SmaccSignal subscription");
+        conn.disconnect();
+      }
+
+      this->stateCallbackConnections.clear();
+
+      for (auto &conn : this->stateLightCallbackConnections_)
+      {
+        conn.disconnect();
+      }
 
-    this->stateCallbackConnections.clear();
+      this->stateLightCallbackConnections_.clear();
+    }
 
     currentState_ = nullptr;
+    currentStateIndex_ = -1;
+    this->refreshStateReactorDispatchTable();
   }
 
   template <typename StateType>
   void ISmaccStateMachine::notifyOnStateExited(StateType *state)
   {
-    auto fullname = demangleSymbol(typeid(StateType).name());
-
     // then call exit state
-    ROS_WARN_STREAM("state exit: " << fullname);
+    SMACC_TRACE_INFO("state exit: %s", demangleType(typeid(StateType)).c_str());
 
     stateMachineCurrentAction = StateMachineInternalAction::TRANSITIONING;
-    this->unlockStateMachine("state exit");
+    this->unlockStateMachine();
   }
   //-------------------------------------------------------------------------------------------------------
-  template <typename EventType>
-  void ISmaccStateMachine::propagateEventToStateReactors(ISmaccState *st, EventType *ev)
-  {
-    ROS_DEBUG("PROPAGATING EVENT [%s] TO LUs [%s]: ", demangleSymbol<EventType>().c_str(), st->getClassName().c_str());
-    for (auto &sb : st->getStateReactors())
-    {
-      sb->notifyEvent(ev);
-    }
-
-    auto *pst = st->getParentState();
-    if (pst != nullptr)
-    {
-      propagateEventToStateReactors(pst, ev);
-    }
-  }
-
   template <typename InitialStateType>
   void ISmaccStateMachine::buildStateMachineInfo()
   {
@@ -36,15 +36,19 @@ void StateReactor::setOutputEvent()
 template <typename TEv>
 void StateReactor::addInputEvent()
 {
+    auto eventType = TEv::static_type();
+    if (std::find(eventTypeIds_.begin(), eventTypeIds_.end(), eventType) != eventTypeIds_.end())
+        return;
+
     this->eventTypes.push_back(&typeid(TEv));
+    this->eventTypeIds_.push_back(eventType);
 }
 
 template <typename T, typename TClass>
 void StateReactor::createEventCallback(void (TClass::*callback)(T *), TClass *object)
 {
-    const auto *eventtype = &typeid(T);
-    this->eventCallbacks_[eventtype] = [=](void *msg) {
-        T *evptr = (T *)msg;
+    this->eventCallbacks_[T::static_type()] = [=](const boost::statechart::event_base &ev) {
+        T *evptr = const_cast<T *>(static_cast<const T *>(&ev));
         (object->*callback)(evptr);
     };
 }
@@ -52,9 +56,8 @@ void StateReactor::createEventCallback(void (TClass::*callback)(T *), TClass *ob
 template <typename T>
 void StateReactor::createEventCallback(std::function<void(T *)> callback)
 {
-    const auto *eventtype = &typeid(T);
-    this->eventCallbacks_[eventtype] = [=](void *msg) {
-        T *evptr = (T *)msg;
+    this->eventCallbacks_[T::static_type()] = [=](const boost::statechart::event_base &ev) {
+        T *evptr = const_cast<T *>(static_cast<const T *>(&ev));
         callback(evptr);
     };
 }
@@ -48,11 +48,6 @@ auto optionalNodeHandle(T *) -> ros::NodeHandle
     return ros::NodeHandle("");
 }
 
-inline std::string demangleSymbol(const std::string &name)
-{
-    return demangleSymbol(name.c_str());
-}
-
 inline std::string demangleSymbol(const char *name)
 {
 #if (__GNUC__ && __cplusplus && __GNUC__ >= 3)
@@ -71,26 +66,30 @@ inline std::string demangleSymbol(const char *name)
 #endif
 }
 
-template <typename T>
-inline std::string demangleSymbol()
+inline std::string demangleSymbol(const std::string &name)
 {
-    return demangleSymbol(typeid(T).name());
+    return demangleSymbol(name.c_str());
 }
 
-template <class T>
-inline std::string demangledTypeName()
+// Demangled name of a type. It is demangled only the first time, the returned reference is valid until the end of
+// the process so that later calls do not allocate (thread safe, see type_name_cache.cpp)
+const std::string &demangleType(const std::type_info &tinfo);
+
+inline const std::string &demangleType(const std::type_info *tinfo)
 {
-    return demangleSymbol(typeid(T).name());
+    return demangleType(*tinfo);
 }
 
-inline std::string demangleType(const std::type_info* tinfo)
+template <typename T>
+inline const std::string &demangleSymbol()
 {
-    return demangleSymbol(tinfo->name());
+    return demangleType(typeid(T));
 }
 
-inline std::string demangleType(const std::type_info &tinfo)
+template <class T>
+inline const std::string &demangledTypeName()
 {
-    return demangleSymbol(tinfo.name());
+    return demangleType(typeid(T));
 }
 
 template <typename...>
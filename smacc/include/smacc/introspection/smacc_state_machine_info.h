@@ -154,7 +154,7 @@ void processTransition(smacc::Transition<Ev, Dst, Tag> *t, std::shared_ptr<Smacc
 template <typename Ev, typename Dst, typename Tag>
 void processTransitionAux(smacc::Transition<Ev, Dst, Tag> *, std::shared_ptr<SmaccStateInfo> &sourceState, bool history, TypeInfo::Ptr &transitionTypeInfo)
 {
-    ROS_INFO("State %s Walker transition: %s", sourceState->toShortName().c_str(), demangleSymbol(typeid(Ev).name()).c_str());
+    ROS_INFO("State %s Walker transition: %s", sourceState->toShortName().c_str(), demangleType(typeid(Ev)).c_str());
     std::string transitionTag;
     std::string transitionType;
 
@@ -238,7 +238,7 @@ void SmaccStateInfo::declareTransition(std::shared_ptr<SmaccStateInfo> &dstState
 
 //     transitionInfo.transitionType = transitionType;
 
-//     transitionInfo.eventInfo = std::make_shared<SmaccEventInfo>(TypeInfo::getTypeInfoFromString(demangleSymbol(typeid(EvType<TevSource>).name())));
+//     transitionInfo.eventInfo = std::make_shared<SmaccEventInfo>(TypeInfo::getTypeInfoFromString(demangleType(typeid(EvType<TevSource>))));
 
 //     EventLabel<EvType<TevSource>>(transitionInfo.eventInfo->label);
 //     ROS_ERROR_STREAM("LABEL: " << transitionInfo.eventInfo->label);
@@ -344,7 +344,7 @@ typename std::enable_if<HasOnDefinition<T>::value, void>::type
 CallOnDefinition()
 {
     /* something when T has toString ... */
-    ROS_INFO_STREAM("EXECUTING ONDEFINITION: " << demangleSymbol(typeid(T).name()));
+    ROS_INFO_STREAM("EXECUTING ONDEFINITION: " << demangleType(typeid(T)));
     T::staticConfigure();
 }
 
@@ -352,7 +352,7 @@ template <typename T>
 typename std::enable_if<!HasOnDefinition<T>::value, void>::type
 CallOnDefinition()
 {
-    ROS_INFO_STREAM("static OnDefinition: dont exist for " << demangleSymbol(typeid(T).name()));
+    ROS_INFO_STREAM("static OnDefinition: dont exist for " << demangleType(typeid(T)));
     /* something when T has toString ... */
 }
 
@@ -7,6 +7,8 @@
 #pragma once
 #include <smacc/smacc_client_behavior_base.h>
 #include <smacc/smacc_signal.h>
+#include <smacc/smacc_cancellation_token.h>
+#include <boost/optional.hpp>
 #include <thread>
 #include <condition_variable>
 #include <mutex>
@@ -15,17 +17,17 @@
 namespace smacc
 {
     template <typename AsyncCB, typename Orthogonal>
-    struct EvCbFinished : sc::event<EvCbFinished<AsyncCB, Orthogonal>>
+    struct EvCbFinished : sc::event<EvCbFinished<AsyncCB, Orthogonal>, SmaccAllocator>
     {
     };
 
     template <typename AsyncCB, typename Orthogonal>
-    struct EvCbSuccess : sc::event<EvCbSuccess<AsyncCB, Orthogonal>>
+    struct EvCbSuccess : sc::event<EvCbSuccess<AsyncCB, Orthogonal>, SmaccAllocator>
     {
     };
 
     template <typename AsyncCB, typename Orthogonal>
-    struct EvCbFailure : sc::event<EvCbFailure<AsyncCB, Orthogonal>>
+    struct EvCbFailure : sc::event<EvCbFailure<AsyncCB, Orthogonal>, SmaccAllocator>
     {
     };
 
@@ -39,9 +41,19 @@ namespace smacc
     // (components, states, clients) need to access to this behavior client information it is needed to implement a mutex for the internal
     // state of this behavior. Other example: if this behavior access to some component located in other thread, it is also may be needed
     // to some mutex for that component
-    class SmaccAsyncClientBehavior : public ISmaccClientBehavior
+    //
+    // onEntry and onExit are executed in the shared executor of the asynchronous behaviors (SmaccExecutor), onExit runs
+    // as a continuation of onEntry: once the state is leaving and onEntry has finished.
+    //
+    // When the state is leaving, the cancellation token is cancelled: a slow onEntry should check isCancelled() (or wait
+    // with getCancellationToken().waitForCancellation() instead of sleeping) and return. The transition waits for onExit
+    // at most the exit deadline (ros param ~async_behavior_exit_deadline or setExitDeadline, 0 means no deadline), then
+    // the behavior is detached: it keeps running in the executor and it is destroyed when it finishes.
+    class SmaccAsyncClientBehavior : public ISmaccClientBehavior, public std::enable_shared_from_this<SmaccAsyncClientBehavior>
     {
     public:
+        SmaccAsyncClientBehavior();
+
         template <typename TOrthogonal, typename TSourceObject>
         void onOrthogonalAllocation();
 
@@ -60,14 +72,35 @@ namespace smacc
         virtual void executeOnEntry() override;
         virtual void executeOnExit() override;
 
+        // ignored once the behavior is cancelled (the owner state is leaving)
         void postSuccessEvent();
         void postFailureEvent();
 
+        const CancellationToken &getCancellationToken() const;
+
+        // true once the state is leaving
+        bool isCancelled() const;
+
+        // overrides the exit deadline of the state machine for this behavior
+        void setExitDeadline(ros::Duration deadline);
+
         virtual void dispose() override;
 
     private:
-        std::future<int> onEntryThread_;
-        std::future<int> onExitThread_;
+        // runs onExit in the executor (entryMutex_ locked)
+        void postExit();
+
+        std::mutex entryMutex_;
+        bool entryFinished_;
+        bool exitRequested_;
+
+        // set when onExit finishes (dispose waits for it)
+        std::promise<void> exitPromise_;
+        std::future<void> exitFuture_;
+
+        CancellationToken cancellationToken_;
+
+        boost::optional<ros::Duration> exitDeadline_;
 
         std::function<void()> postFinishEventFn_;
         std::function<void()> postSuccessEventFn_;
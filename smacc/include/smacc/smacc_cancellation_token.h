@@ -0,0 +1,38 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace smacc
+{
+// Cooperative cancellation request. The owner cancels it (ie: the state is leaving) and the long running code checks
+// it periodically or waits on it instead of sleeping.
+class CancellationToken
+{
+public:
+    CancellationToken();
+
+    CancellationToken(const CancellationToken &) = delete;
+    CancellationToken &operator=(const CancellationToken &) = delete;
+
+    bool isCancelled() const;
+
+    // sleeps until the timeout or the cancellation, returns true if it was cancelled
+    bool waitForCancellation(std::chrono::nanoseconds timeout) const;
+
+    void cancel();
+
+private:
+    std::atomic<bool> cancelled_;
+
+    mutable std::mutex mutex_;
+    mutable std::condition_variable cancelledCondition_;
+};
+} // namespace smacc
@@ -7,6 +7,7 @@
 
 #include <smacc/common.h>
 #include <smacc/component.h>
+#include <smacc/smacc_type_index.h>
 #include <typeinfo>
 
 namespace smacc
@@ -77,6 +78,9 @@ protected:
     // components
     std::map<ComponentKey, std::shared_ptr<smacc::ISmaccComponent>> components_;
 
+    // the same components indexed by their type for constant time getComponent calls
+    TypeIndexedRegistry<ISmaccComponent> componentIndex_;
+
     template <typename SmaccComponentType, typename TOrthogonal, typename TClient, typename... TArgs>
     SmaccComponentType *createComponent(TArgs... targs);
 
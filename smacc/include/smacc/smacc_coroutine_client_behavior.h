@@ -0,0 +1,435 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+
+#pragma once
+#include <smacc/smacc_asynchronous_client_behavior.h>
+#include <smacc/smacc_state_machine.h>
+
+// The coroutine client behaviors need a C++20 compiler (ie: add_compile_options(-std=c++20) in the package
+// that defines the behavior). The smacc library itself does not need it.
+#if defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+#include <boost/optional.hpp>
+
+namespace smacc
+{
+    class SmaccCoroutineClientBehavior;
+
+    // return type of SmaccCoroutineClientBehavior::onEntryCoroutine
+    class CbCoroutine
+    {
+    public:
+        struct promise_type
+        {
+            CbCoroutine get_return_object()
+            {
+                return CbCoroutine(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            // it is started by the behavior (executeOnEntry) and the frame is destroyed by the behavior
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+
+            void return_void() {}
+
+            void unhandled_exception() { exception = std::current_exception(); }
+
+            std::exception_ptr exception;
+        };
+
+        CbCoroutine() = default;
+
+        CbCoroutine(CbCoroutine &&other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+
+        CbCoroutine &operator=(CbCoroutine &&other) noexcept
+        {
+            if (this != &other)
+            {
+                this->destroy();
+                handle_ = other.handle_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+
+        CbCoroutine(const CbCoroutine &) = delete;
+        CbCoroutine &operator=(const CbCoroutine &) = delete;
+
+        ~CbCoroutine() { this->destroy(); }
+
+    private:
+        explicit CbCoroutine(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+        // the locals of the coroutine (and its pending awaiters) are destroyed
+        void destroy()
+        {
+            if (handle_)
+            {
+                handle_.destroy();
+                handle_ = nullptr;
+            }
+        }
+
+        std::coroutine_handle<promise_type> handle_;
+
+        friend class SmaccCoroutineClientBehavior;
+    };
+
+    enum class CbActionResultType
+    {
+        SUCCEEDED,
+        ABORTED,
+        PREEMPTED,
+        REJECTED
+    };
+
+    template <typename ResultConstPtr>
+    struct CbActionResult
+    {
+        CbActionResultType type;
+        ResultConstPtr result;
+    };
+
+    namespace coroutine_detail
+    {
+        // Link between a suspended coroutine and the thread that wakes it up (ros callbacks). The behavior clears it
+        // when the coroutine is cancelled, the wake ups that are already queued in the state machine thread are
+        // then ignored. It is only accessed from the state machine thread (or from the orthogonal threads while the
+        // state machine thread waits for them).
+        struct CoroutineScope
+        {
+            ISmaccStateMachine *stateMachine;
+            SmaccCoroutineClientBehavior *behavior;
+        };
+
+        // value received by a pending co_await (only the first one is kept)
+        template <typename T>
+        class AwaitSlot
+        {
+        public:
+            bool set(T value)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (value_)
+                    return false;
+
+                value_ = std::move(value);
+                return true;
+            }
+
+            T take()
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return std::move(*value_);
+            }
+
+        private:
+            std::mutex mutex_;
+            boost::optional<T> value_;
+        };
+
+        template <>
+        class AwaitSlot<void>
+        {
+        public:
+            bool set()
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (set_)
+                    return false;
+
+                set_ = true;
+                return true;
+            }
+
+            void take() {}
+
+        private:
+            std::mutex mutex_;
+            bool set_ = false;
+        };
+
+        void resume(const std::shared_ptr<CoroutineScope> &scope);
+
+        // Suspends the coroutine until the callback passed to the subscribe function is called (from any thread).
+        // The coroutine is resumed in the state machine thread with the value of the callback. TSubscribe receives
+        // the callback and returns a connection (or any object that stops the notifications when it is destroyed).
+        template <typename T, typename TSubscribe>
+        class CallbackAwaiter
+        {
+        public:
+            CallbackAwaiter(std::shared_ptr<CoroutineScope> scope, TSubscribe subscribe)
+                : scope_(std::move(scope)), subscribe_(std::move(subscribe)), slot_(std::make_shared<AwaitSlot<T>>())
+            {
+            }
+
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<>)
+            {
+                auto scope = scope_;
+                auto slot = slot_;
+                auto subscription = subscribe_([scope, slot](auto &&... value) {
+                    if (slot->set(std::forward<decltype(value)>(value)...))
+                    {
+                        scope->stateMachine->runOnStateMachineThread([scope] { coroutine_detail::resume(scope); });
+                    }
+                });
+
+                subscription_ = std::make_shared<decltype(subscription)>(std::move(subscription));
+            }
+
+            T await_resume()
+            {
+                subscription_ = nullptr;
+                return slot_->take();
+            }
+
+        private:
+            std::shared_ptr<CoroutineScope> scope_;
+            TSubscribe subscribe_;
+            std::shared_ptr<AwaitSlot<T>> slot_;
+            std::shared_ptr<void> subscription_;
+        };
+
+        // disconnects the signal connection on destruction (when the coroutine is resumed or cancelled), for
+        // boost::signals2::connection and SmaccLightConnection
+        template <typename TConnection>
+        class SignalSubscription
+        {
+        public:
+            explicit SignalSubscription(TConnection connection) : connection_(connection) {}
+
+            SignalSubscription(SignalSubscription &&other) noexcept : connection_(other.connection_)
+            {
+                other.connection_ = TConnection();
+            }
+
+            SignalSubscription &operator=(SignalSubscription &&other) noexcept
+            {
+                connection_.disconnect();
+                connection_ = other.connection_;
+                other.connection_ = TConnection();
+                return *this;
+            }
+
+            ~SignalSubscription() { connection_.disconnect(); }
+
+        private:
+            TConnection connection_;
+        };
+    } // namespace coroutine_detail
+
+    // Client behavior whose onEntry is a C++20 coroutine (onEntryCoroutine). It can co_await action results, topic
+    // messages, signals (ie: timer ticks) and sleeps without blocking any thread, so any number of these behaviors can
+    // be waiting at the same time:
+    //
+    //  CbCoroutine onEntryCoroutine() override
+    //  {
+    //      moveBaseClient_->sendGoal(goal);
+    //      auto result = co_await awaitResult(*moveBaseClient_);
+    //      co_await sleep(ros::Duration(1.0));
+    //      auto msg = co_await awaitMessage(*odomClient_);
+    //      ...
+    //  }
+    //
+    // The coroutine runs in the state machine thread (as the event handlers of the states): executeOnEntry queues its
+    // start (it may run in the thread pool with ~parallel_orthogonals) and it is resumed by the state machine thread when
+    // the awaited value arrives. When the owner state
+    // is left, the pending coroutine is cancelled (its frame is destroyed and the pending co_await are disconnected).
+    // When the coroutine finishes, EvCbFinished<TBehavior, TOrthogonal> is posted.
+    class SmaccCoroutineClientBehavior : public ISmaccClientBehavior
+    {
+    public:
+        template <typename TOrthogonal, typename TSourceObject>
+        void onOrthogonalAllocation()
+        {
+            postFinishEventFn_ = [this] {
+                this->postEvent<EvCbFinished<TSourceObject, TOrthogonal>>();
+            };
+        }
+
+        virtual ~SmaccCoroutineClientBehavior()
+        {
+            this->cancel();
+        }
+
+        // false while the coroutine is suspended
+        bool isFinished() const { return finished_; }
+
+    protected:
+        virtual CbCoroutine onEntryCoroutine() = 0;
+
+        // suspends the coroutine until the callback passed to subscribe is called, see coroutine_detail::CallbackAwaiter
+        template <typename T, typename TSubscribe>
+        coroutine_detail::CallbackAwaiter<T, TSubscribe> awaitCallback(TSubscribe subscribe)
+        {
+            return coroutine_detail::CallbackAwaiter<T, TSubscribe>(scope_, std::move(subscribe));
+        }
+
+        // next emission of a signal with one or no arguments, ie: co_await awaitSignal(timer->getTimerTickSignal())
+        template <typename TSignal>
+        auto awaitSignal(TSignal &signal)
+        {
+            return this->awaitSignalImpl(signal, static_cast<typename TSignal::signature_type *>(nullptr));
+        }
+
+        // next message of a SmaccSubscriberClient (the shared message, it is not copied)
+        template <typename TSubscriberClient>
+        auto awaitMessage(TSubscriberClient &client)
+        {
+            typedef typename TSubscriberClient::TMessageConstPtr MessageConstPtr;
+            auto *signal = &client.onMessagePtrReceived_;
+            return this->awaitCallback<MessageConstPtr>([signal](auto callback) {
+                return coroutine_detail::SignalSubscription(signal->connect(
+                    [callback](const MessageConstPtr &msg) { callback(msg); }));
+            });
+        }
+
+        // result of the current goal of a SmaccActionClientBase
+        template <typename TActionClient>
+        auto awaitResult(TActionClient &client)
+        {
+            typedef typename TActionClient::ResultConstPtr ResultConstPtr;
+            typedef CbActionResult<ResultConstPtr> Result;
+
+            auto *clientptr = &client;
+            return this->awaitCallback<Result>([clientptr](auto callback) {
+                auto connect = [&](auto &signal, CbActionResultType type) {
+                    return signal.connect([callback, type](const ResultConstPtr &result) { callback(Result{type, result}); });
+                };
+
+                // one connection for each possible result, all of them are disconnected on resumption
+                return std::make_tuple(coroutine_detail::SignalSubscription(connect(clientptr->onSucceeded_, CbActionResultType::SUCCEEDED)),
+                                       coroutine_detail::SignalSubscription(connect(clientptr->onAborted_, CbActionResultType::ABORTED)),
+                                       coroutine_detail::SignalSubscription(connect(clientptr->onPreempted_, CbActionResultType::PREEMPTED)),
+                                       coroutine_detail::SignalSubscription(connect(clientptr->onRejected_, CbActionResultType::REJECTED)));
+            });
+        }
+
+        // ros time based sleep (a oneshot ros timer)
+        auto sleep(ros::Duration duration)
+        {
+            auto nh = this->getNode();
+            return this->awaitCallback<void>([nh, duration](auto callback) mutable {
+                return nh.createTimer(duration, [callback](const ros::TimerEvent &) { callback(); }, true);
+            });
+        }
+
+        virtual void executeOnEntry() override
+        {
+            this->cancel();
+
+            scope_ = std::make_shared<coroutine_detail::CoroutineScope>();
+            scope_->stateMachine = this->getStateMachine();
+            scope_->behavior = this;
+
+            finished_ = false;
+            coroutine_ = this->onEntryCoroutine();
+
+            // ignored if the behavior is cancelled before the start
+            auto scope = scope_;
+            scope_->stateMachine->runOnStateMachineThread([scope] { coroutine_detail::resume(scope); });
+        }
+
+        virtual void executeOnExit() override
+        {
+            this->cancel();
+            this->onExit();
+        }
+
+    private:
+        template <typename TSignal>
+        auto awaitSignalImpl(TSignal &signal, void (*)())
+        {
+            auto *signalptr = &signal;
+            return this->awaitCallback<void>([signalptr](auto callback) {
+                return coroutine_detail::SignalSubscription(signalptr->connect([callback]() { callback(); }));
+            });
+        }
+
+        template <typename TSignal, typename TArg>
+        auto awaitSignalImpl(TSignal &signal, void (*)(TArg))
+        {
+            typedef typename std::decay<TArg>::type T;
+            auto *signalptr = &signal;
+            return this->awaitCallback<T>([signalptr](auto callback) {
+                return coroutine_detail::SignalSubscription(signalptr->connect([callback](TArg value) { callback(value); }));
+            });
+        }
+
+        // runs the coroutine until its next suspension point (state machine thread)
+        void resume()
+        {
+            auto handle = coroutine_.handle_;
+            if (!handle || handle.done())
+                return;
+
+            handle.resume();
+
+            if (handle.done())
+            {
+                finished_ = true;
+                if (handle.promise().exception)
+                {
+                    try
+                    {
+                        std::rethrow_exception(handle.promise().exception);
+                    }
+                    catch (const std::exception &e)
+                    {
+                        ROS_ERROR("[%s] Exception on coroutine: %s", this->getName().c_str(), e.what());
+                    }
+                }
+
+                if (postFinishEventFn_)
+                    postFinishEventFn_();
+            }
+        }
+
+        void cancel()
+        {
+            if (scope_ != nullptr)
+            {
+                scope_->behavior = nullptr;
+                scope_ = nullptr;
+            }
+
+            coroutine_ = CbCoroutine();
+        }
+
+        std::shared_ptr<coroutine_detail::CoroutineScope> scope_;
+
+        CbCoroutine coroutine_;
+
+        bool finished_ = true;
+
+        std::function<void()> postFinishEventFn_;
+
+        friend void coroutine_detail::resume(const std::shared_ptr<coroutine_detail::CoroutineScope> &scope);
+    };
+
+    namespace coroutine_detail
+    {
+        inline void resume(const std::shared_ptr<CoroutineScope> &scope)
+        {
+            // null if the coroutine was cancelled after this wake up was queued
+            if (scope->behavior != nullptr)
+                scope->behavior->resume();
+        }
+    } // namespace coroutine_detail
+} // namespace smacc
+
+#endif
@@ -4,6 +4,7 @@
 #include <boost/statechart/event.hpp>
 
 #include <smacc/smacc_types.h>
+#include <smacc/smacc_pool_allocator.h>
 
 namespace smacc
 {
@@ -13,7 +14,7 @@ using namespace smacc::introspection;
 using namespace smacc::default_transition_tags;
 
 template <typename ActionFeedback, typename TOrthogonal>
-struct EvActionFeedback : sc::event<EvActionFeedback<ActionFeedback, TOrthogonal>>
+struct EvActionFeedback : sc::event<EvActionFeedback<ActionFeedback, TOrthogonal>, SmaccAllocator>
 {
   smacc::client_bases::ISmaccActionClient *client;
   ActionFeedback feedbackMessage;
@@ -21,14 +22,14 @@ struct EvActionFeedback : sc::event<EvActionFeedback<ActionFeedback, TOrthogonal
 };
 
 template <typename TSource, typename TOrthogonal>
-struct EvActionResult : sc::event<EvActionResult<TSource, TOrthogonal>>
+struct EvActionResult : sc::event<EvActionResult<TSource, TOrthogonal>, SmaccAllocator>
 {
   typename TSource::Result resultMessage;
 };
 
 //--------------------------------
 template <typename TSource, typename TOrthogonal>
-struct EvActionSucceeded : sc::event<EvActionSucceeded<TSource, TOrthogonal>>
+struct EvActionSucceeded : sc::event<EvActionSucceeded<TSource, TOrthogonal>, SmaccAllocator>
 {
   typename TSource::Result resultMessage;
 
@@ -52,7 +53,7 @@ struct EvActionSucceeded : sc::event<EvActionSucceeded<TSource, TOrthogonal>>
 };
 
 template <typename TSource, typename TOrthogonal>
-struct EvActionAborted : sc::event<EvActionAborted<TSource, TOrthogonal>>
+struct EvActionAborted : sc::event<EvActionAborted<TSource, TOrthogonal>, SmaccAllocator>
 {
   typename TSource::Result resultMessage;
 
@@ -76,7 +77,7 @@ struct EvActionAborted : sc::event<EvActionAborted<TSource, TOrthogonal>>
 };
 
 template <typename TSource, typename TOrthogonal>
-struct EvActionPreempted : sc::event<EvActionPreempted<TSource, TOrthogonal>>
+struct EvActionPreempted : sc::event<EvActionPreempted<TSource, TOrthogonal>, SmaccAllocator>
 {
   typename TSource::Result resultMessage;
 
@@ -100,7 +101,7 @@ struct EvActionPreempted : sc::event<EvActionPreempted<TSource, TOrthogonal>>
 };
 
 template <typename TSource, typename TOrthogonal>
-struct EvActionRejected : sc::event<EvActionRejected<TSource, TOrthogonal>>
+struct EvActionRejected : sc::event<EvActionRejected<TSource, TOrthogonal>, SmaccAllocator>
 {
   typename TSource::Result resultMessage;
 
@@ -124,13 +125,13 @@ struct EvActionRejected : sc::event<EvActionRejected<TSource, TOrthogonal>>
 };
 
 template <typename StateType>
-struct EvSequenceFinished : sc::event<EvSequenceFinished<StateType>>
+struct EvSequenceFinished : sc::event<EvSequenceFinished<StateType>, SmaccAllocator>
 {
   
 };
 
 template <typename TSource>
-struct EvLoopContinue : sc::event<EvLoopContinue<TSource>>
+struct EvLoopContinue : sc::event<EvLoopContinue<TSource>, SmaccAllocator>
 {
   static std::string getDefaultTransitionTag()
   {
@@ -144,7 +145,7 @@ struct EvLoopContinue : sc::event<EvLoopContinue<TSource>>
 };
 
 template <typename TSource>
-struct EvLoopEnd : sc::event<EvLoopEnd<TSource>>
+struct EvLoopEnd : sc::event<EvLoopEnd<TSource>, SmaccAllocator>
 {
   static std::string getDefaultTransitionTag()
   {
@@ -158,9 +159,8 @@ struct EvLoopEnd : sc::event<EvLoopEnd<TSource>>
 };
 
 template <typename TSource, typename TOrthogonal>
-struct EvTopicInitialMessage : sc::event<EvTopicInitialMessage<TSource, TOrthogonal>>
+struct EvTopicInitialMessage : sc::event<EvTopicInitialMessage<TSource, TOrthogonal>, SmaccAllocator>
 {
-  //typename EvTopicInitialMessage<SensorBehaviorType>::TMessageType msgData;
   static std::string getEventLabel()
   {
     auto typeinfo = TypeInfo::getTypeInfoFromType<typename TSource::TMessageType>();
@@ -169,11 +169,12 @@ struct EvTopicInitialMessage : sc::event<EvTopicInitialMessage<TSource, TOrthogo
     return label;
   }
 
-  typename TSource::TMessageType msgData;
+  // the message received by the subscriber, shared (not copied) with the other events and signals of the message
+  typename TSource::TMessageType::ConstPtr msgData;
 };
 
 template <typename TSource, typename TOrthogonal>
-struct EvTopicMessage : sc::event<EvTopicMessage<TSource, TOrthogonal>>
+struct EvTopicMessage : sc::event<EvTopicMessage<TSource, TOrthogonal>, SmaccAllocator>
 {
   static std::string getEventLabel()
   {
@@ -183,7 +184,11 @@ struct EvTopicMessage : sc::event<EvTopicMessage<TSource, TOrthogonal>>
     return label;
   }
 
-  typename TSource::TMessageType msgData;
+  // the message received by the subscriber, shared (not copied) with the other events and signals of the message
+  typename TSource::TMessageType::ConstPtr msgData;
+
+  // released with the event, the conflate policy of the subscriber posts the next message then (see TopicEventBridge)
+  std::shared_ptr<void> conflationToken;
 };
 } // namespace default_events
 } // namespace smacc
\ No newline at end of file
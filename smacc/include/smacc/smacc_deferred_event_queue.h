@@ -0,0 +1,86 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#pragma once
+
+#include <boost/intrusive_ptr.hpp>
+#include <boost/statechart/event_base.hpp>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace smacc
+{
+struct DeferredEventStatistics
+{
+    // events held because they were posted with EventLifeTime::CURRENT_STATE during a transition
+    unsigned long deferred;
+    // deferred events posted once the next state was steady
+    unsigned long delivered;
+    // events discarded because the queue was full or, with the DISCARD policy, because the state they were posted
+    // from is not the current state anymore
+    unsigned long dropped;
+
+    double totalDeferredSeconds;
+    double maxDeferredSeconds;
+};
+
+// Bounded queue of the events posted with EventLifeTime::CURRENT_STATE while the state machine is exiting a state or
+// transitioning. Each event is tagged with the state sequence number (ISmaccStateMachine::getCurrentStateCounter) of
+// the moment it was posted. When the next state is steady the queued events are posted in the same order, except with
+// the DISCARD policy, which drops the events of the states already exited (the events posted while the new state was
+// being created are kept). A capacity of 0 discards them directly (as the state machine used to do).
+class DeferredEventQueue
+{
+public:
+    enum class Policy
+    {
+        // the events of the exited state are also posted (to the new state)
+        DELIVER,
+        DISCARD
+    };
+
+    typedef boost::intrusive_ptr<const boost::statechart::event_base> EventPtr;
+
+    DeferredEventQueue(std::size_t capacity, Policy policy);
+
+    DeferredEventQueue(const DeferredEventQueue &) = delete;
+    DeferredEventQueue &operator=(const DeferredEventQueue &) = delete;
+
+    // shouldDefer is evaluated with the queue locked, so that the event cannot be queued after the flush of the
+    // transition it belongs to. Returns false if the event is not deferred (then it must be posted normally).
+    // Dropped events (queue full) are also considered deferred. state is the state sequence number read before
+    // checking the transition.
+    bool defer(const EventPtr &ev, unsigned long state, const std::function<bool()> &shouldDefer);
+
+    // empties the queue, post is called for each event to deliver. currentState is the sequence number of the new state
+    void flush(unsigned long currentState, const std::function<void(const EventPtr &)> &post);
+
+    DeferredEventStatistics getStatistics() const;
+
+    std::size_t getCapacity() const;
+
+    Policy getPolicy() const;
+
+private:
+    struct Entry
+    {
+        EventPtr event;
+        unsigned long state;
+        std::chrono::steady_clock::time_point deferredAt;
+    };
+
+    const std::size_t capacity_;
+    const Policy policy_;
+
+    mutable std::mutex mutex_;
+
+    std::deque<Entry> entries_;
+
+    DeferredEventStatistics statistics_;
+};
+} // namespace smacc
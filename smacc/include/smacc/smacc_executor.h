@@ -0,0 +1,89 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#pragma once
+
+#include <smacc/smacc_thread_pool.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace smacc
+{
+struct ExecutorStatistics
+{
+    // tasks started since the creation of the executor
+    unsigned long tasks;
+
+    // time from the submission of a task until a worker started it
+    double totalQueueWaitSeconds;
+    double maxQueueWaitSeconds;
+
+    // tasks that are queued or being executed
+    std::size_t pendingTasks;
+
+    std::size_t threads;
+};
+
+// Bounded thread pool that measures how long the tasks wait in the queue. If the queue wait grows, the workers are
+// saturated (ie: long running tasks) and the number of threads should be increased.
+//
+// The pool does not grow: a task that blocks (ie: an asynchronous behavior waiting for a service or a sensor) keeps
+// its worker until it returns, so when all the workers are blocked the next tasks wait in the queue until one of them
+// finishes (or forever). A watchdog thread logs a warning while the oldest queued task has been waiting longer than
+// the queue wait warning threshold, also if it never starts; in that case increase the number of threads
+// (~async_behavior_threads for the asynchronous behaviors executor).
+class SmaccExecutor
+{
+public:
+    // queueWaitWarning: seconds, zero disables the watchdog
+    explicit SmaccExecutor(std::size_t threadCount, double queueWaitWarning = 0);
+
+    // pending tasks are executed before the workers are joined
+    ~SmaccExecutor();
+
+    SmaccExecutor(const SmaccExecutor &) = delete;
+    SmaccExecutor &operator=(const SmaccExecutor &) = delete;
+
+    void post(std::function<void()> task);
+
+    ExecutorStatistics getStatistics() const;
+
+    // Executor shared by all the asynchronous client behaviors (SmaccAsyncClientBehavior) of the process. It is created
+    // on the first use with the ros param ~async_behavior_threads workers (default 8) and the ros param
+    // ~async_behavior_queue_wait_warning seconds (default 1.0). It is never destroyed.
+    static SmaccExecutor &getAsyncBehaviorExecutor();
+
+private:
+    void recordQueueWait(std::chrono::steady_clock::duration wait);
+
+    void watchdogLoop();
+
+    std::atomic<unsigned long> tasks_;
+
+    // nanoseconds
+    std::atomic<unsigned long> totalQueueWait_;
+    std::atomic<unsigned long> maxQueueWait_;
+
+    std::chrono::steady_clock::duration queueWaitWarning_;
+
+    // submission time of the tasks that did not start yet (only with the watchdog), by submission order
+    std::mutex queuedMutex_;
+    std::map<unsigned long, std::chrono::steady_clock::time_point> queued_;
+    unsigned long nextTaskId_;
+
+    std::condition_variable watchdogWakeUp_;
+    bool stopping_;
+    std::thread watchdog_;
+
+    // the last member: the tasks executed while it is destroyed still use the other members
+    SmaccThreadPool pool_;
+};
+} // namespace smacc
@@ -1,4 +1,5 @@
+#pragma once
 #include <boost/statechart/fifo_scheduler.hpp>
 #include <smacc/smacc_fifo_worker.h>
 
-typedef boost::statechart::fifo_scheduler<SmaccFifoWorker, SmaccAllocator> SmaccFifoScheduler;
\ No newline at end of file
+typedef boost::statechart::fifo_scheduler<SmaccFifoWorker, SmaccAllocator> SmaccFifoScheduler;
@@ -1,5 +1,13 @@
 #pragma once
 #include <boost/statechart/fifo_worker.hpp>
+#include <smacc/smacc_lockfree_fifo_worker.h>
+#include <smacc/smacc_pool_allocator.h>
 
-typedef std::allocator<void> SmaccAllocator;
-typedef boost::statechart::fifo_worker<SmaccAllocator> SmaccFifoWorker;
\ No newline at end of file
+// The event queue backend of the state machine is selected at compile time. Define SMACC_LOCKFREE_EVENT_QUEUE
+// (cmake option with the same name) to use the lock-free multi-producer/single-consumer queue instead of the
+// mutex-based boost::statechart::fifo_worker
+#ifdef SMACC_LOCKFREE_EVENT_QUEUE
+typedef smacc::SmaccLockFreeFifoWorker<SmaccAllocator> SmaccFifoWorker;
+#else
+typedef boost::statechart::fifo_worker<SmaccAllocator> SmaccFifoWorker;
+#endif
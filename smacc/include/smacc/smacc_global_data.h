@@ -0,0 +1,184 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#pragma once
+
+#include <smacc/smacc_signal.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace smacc
+{
+class GlobalDataStore;
+
+// immutable value of a global variable, a new record is created on each set
+struct GlobalDataRecord
+{
+    virtual ~GlobalDataRecord() {}
+
+    const std::type_info *type;
+
+    // stringification for the status messages
+    std::string (*toString)(const GlobalDataRecord &record);
+};
+
+template <typename T>
+struct TypedGlobalDataRecord : GlobalDataRecord
+{
+    T value;
+};
+
+// Handle of an interned global variable. Getting it needs a lookup by name, but then the reads and writes through it
+// are direct accesses to the variable slot.
+template <typename T>
+class GlobalDataKey
+{
+public:
+    GlobalDataKey() : index_(-1), store_(nullptr) {}
+
+    bool isValid() const { return index_ >= 0; }
+
+    int getIndex() const { return index_; }
+
+private:
+    GlobalDataKey(int index, const GlobalDataStore *store) : index_(index), store_(store) {}
+
+    int index_;
+
+    // the keys of other state machines are rejected
+    const GlobalDataStore *store_;
+
+    friend class GlobalDataStore;
+};
+
+// Blackboard of the global variables of the state machine (setGlobalSMData/getGlobalSMData).
+//
+// Each variable is a slot that points to its current immutable value record (RCU style): a set creates a new record
+// and swaps the pointer, readers get a shared pointer to the record they loaded and can use it by reference for as
+// long as they want, without copies and without any lock shared with the state machine. The slot table is replaced
+// (copy on write) when a new variable is interned, so the accesses through keys do not take any lock. Only the
+// lookups by name take the (short) keys mutex.
+class GlobalDataStore
+{
+public:
+    typedef SmaccSignal<void(const GlobalDataRecord &)> ChangedSignal;
+
+    struct Slot
+    {
+        std::string name;
+
+        // accessed through std::atomic_load/std::atomic_store
+        std::shared_ptr<const GlobalDataRecord> record;
+
+        // incremented on each set
+        std::atomic<uint64_t> version;
+
+        ChangedSignal changed;
+    };
+
+    GlobalDataStore();
+
+    ~GlobalDataStore();
+
+    GlobalDataStore(const GlobalDataStore &) = delete;
+    GlobalDataStore &operator=(const GlobalDataStore &) = delete;
+
+    template <typename T>
+    GlobalDataKey<T> getKey(const std::string &name)
+    {
+        return GlobalDataKey<T>(this->intern(name), this);
+    }
+
+    // the variable is created if it does not exist
+    int intern(const std::string &name);
+
+    // -1 if it does not exist
+    int find(const std::string &name) const;
+
+    template <typename T>
+    void set(const GlobalDataKey<T> &key, T value)
+    {
+        auto record = std::make_shared<TypedGlobalDataRecord<T>>();
+        record->type = &typeid(T);
+        record->toString = &GlobalDataStore::recordToString<T>;
+        record->value = std::move(value);
+
+        auto *slot = this->getKeySlot(key.index_, key.store_);
+        if (slot == nullptr)
+            return;
+
+        std::atomic_store(&slot->record, std::shared_ptr<const GlobalDataRecord>(record));
+        slot->version.fetch_add(1, std::memory_order_release);
+
+        slot->changed(*record);
+    }
+
+    // null if the variable was not set, it has other type or the key is not valid
+    template <typename T>
+    std::shared_ptr<const T> get(const GlobalDataKey<T> &key) const
+    {
+        auto *slot = this->getKeySlot(key.index_, key.store_);
+        if (slot == nullptr)
+            return nullptr;
+
+        auto record = std::atomic_load(&slot->record);
+        if (record == nullptr || *record->type != typeid(T))
+            return nullptr;
+
+        auto typedRecord = static_cast<const TypedGlobalDataRecord<T> *>(record.get());
+        return std::shared_ptr<const T>(record, &typedRecord->value);
+    }
+
+    // the callback is called from the thread that sets the variable (not connected if the key is not valid)
+    template <typename T>
+    boost::signals2::connection onChanged(const GlobalDataKey<T> &key, std::function<void(const T &)> callback)
+    {
+        auto *slot = this->getKeySlot(key.index_, key.store_);
+        if (slot == nullptr)
+            return boost::signals2::connection();
+
+        return slot->changed.connect([callback](const GlobalDataRecord &record) {
+            if (*record.type == typeid(T))
+                callback(static_cast<const TypedGlobalDataRecord<T> &>(record).value);
+        });
+    }
+
+    std::size_t size() const;
+
+    // slots of the variables, indexed by GlobalDataKey::getIndex(). Null if the index is out of range
+    Slot *getSlot(int index) const;
+
+private:
+    // the slot of a key of this store, logs an error and returns null for invalid or foreign keys
+    Slot *getKeySlot(int index, const GlobalDataStore *store) const;
+
+    template <typename T>
+    static std::string recordToString(const GlobalDataRecord &record)
+    {
+        std::stringstream ss;
+        ss << static_cast<const TypedGlobalDataRecord<T> &>(record).value;
+        return ss.str();
+    }
+
+    std::atomic<const std::vector<Slot *> *> slotTable_;
+
+    // the slots and the old versions of the slot table (readers may still be using them)
+    std::list<std::unique_ptr<Slot>> slots_;
+    std::list<std::unique_ptr<const std::vector<Slot *>>> slotTableVersions_;
+
+    mutable std::mutex keysMutex_;
+    std::map<std::string, int> keys_;
+};
+} // namespace smacc
@@ -0,0 +1,239 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#pragma once
+
+#include <boost/container/small_vector.hpp>
+#include <boost/optional.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+namespace smacc
+{
+// mutex of the signals that are only connected, disconnected and invoked from one thread
+struct SmaccNullMutex
+{
+    void lock() {}
+    void unlock() {}
+};
+
+namespace light_signal_detail
+{
+// state of a slot shared by the signal and its connections
+struct SlotBase
+{
+    explicit SlotBase(const void *scope) : scope(scope), connected(true) {}
+
+    virtual ~SlotBase() {}
+
+    const void *scope;
+
+    std::atomic<bool> connected;
+};
+
+template <typename TFunction>
+struct SlotBody : SlotBase
+{
+    SlotBody(TFunction function, const void *scope) : SlotBase(scope), function(std::move(function)) {}
+
+    TFunction function;
+};
+
+template <typename R>
+struct LastValue
+{
+    template <typename TFunction, typename... Args>
+    void call(TFunction &function, Args &... args)
+    {
+        value = function(args...);
+    }
+
+    boost::optional<R> get() { return value; }
+
+    boost::optional<R> value;
+};
+
+template <>
+struct LastValue<void>
+{
+    template <typename TFunction, typename... Args>
+    void call(TFunction &function, Args &... args)
+    {
+        function(args...);
+    }
+
+    void get() {}
+};
+} // namespace light_signal_detail
+
+// Connection of a SmaccLightSignal slot. Disconnecting does not lock the signal (the slot is removed by the signal
+// later), so it can be done from any thread, also from the slot itself.
+class SmaccLightConnection
+{
+public:
+    SmaccLightConnection() {}
+
+    void disconnect() const
+    {
+        if (auto slot = slot_.lock())
+            slot->connected = false;
+    }
+
+    bool connected() const
+    {
+        auto slot = slot_.lock();
+        return slot != nullptr && slot->connected;
+    }
+
+private:
+    explicit SmaccLightConnection(std::weak_ptr<light_signal_detail::SlotBase> slot) : slot_(std::move(slot)) {}
+
+    std::weak_ptr<light_signal_detail::SlotBase> slot_;
+
+    template <typename Signature, typename Mutex, std::size_t InlineSlots>
+    friend class SmaccLightSignal;
+};
+
+// Low overhead alternative to SmaccSignal (boost::signals2). It has the same connect/invoke interface and it can be
+// used with createSignalConnection (the state scoped connections are disconnected on state exit), but connect returns
+// a SmaccLightConnection. The slots are kept in a small inline buffer, and an invocation only takes a reference to the
+// current slot list: the slots are called without the lock, as in signals2, so a slot may connect or disconnect
+// slots and a disconnection from other thread never waits for a running invocation (the disconnected slot is not
+// called by the later invocations, but it may still be running).
+//
+// The default mutex (SmaccNullMutex) is for signals that are only used from one thread. If the slots are connected
+// from a thread (ie: the state machine thread) and the signal is invoked from other (ie: ros callbacks), use
+// std::mutex.
+//
+// Slots can be connected with a scope (any pointer, ie: the subscriber object) and all the slots of a scope are
+// disconnected at once with disconnect(scope).
+template <typename Signature, typename Mutex = SmaccNullMutex, std::size_t InlineSlots = 2>
+class SmaccLightSignal;
+
+template <typename R, typename... Args, typename Mutex, std::size_t InlineSlots>
+class SmaccLightSignal<R(Args...), Mutex, InlineSlots>
+{
+public:
+    // as the default combiner of boost::signals2 (optional_last_value)
+    typedef typename std::conditional<std::is_void<R>::value, void, boost::optional<R>>::type result_type;
+
+    typedef R signature_type(Args...);
+
+    typedef std::function<R(Args...)> slot_function_type;
+
+    SmaccLightSignal() : slots_(std::make_shared<SlotList>()) {}
+
+    ~SmaccLightSignal()
+    {
+        this->disconnect_all_slots();
+    }
+
+    SmaccLightSignal(const SmaccLightSignal &) = delete;
+    SmaccLightSignal &operator=(const SmaccLightSignal &) = delete;
+
+    template <typename TCallback>
+    SmaccLightConnection connect(TCallback &&callback, const void *scope = nullptr)
+    {
+        auto body = std::make_shared<Body>(slot_function_type(std::forward<TCallback>(callback)), scope);
+
+        std::lock_guard<Mutex> lock(mutex_);
+        auto slots = this->copyConnectedSlots();
+        slots->push_back(body);
+        slots_ = std::move(slots);
+
+        return SmaccLightConnection(body);
+    }
+
+    result_type operator()(Args... args)
+    {
+        std::shared_ptr<const SlotList> slots;
+        {
+            std::lock_guard<Mutex> lock(mutex_);
+            slots = slots_;
+        }
+
+        light_signal_detail::LastValue<R> result;
+
+        // the slots connected meanwhile are not called until the next invocation
+        for (auto &body : *slots)
+        {
+            if (body->connected.load(std::memory_order_acquire))
+                result.call(body->function, args...);
+        }
+
+        return result.get();
+    }
+
+    // disconnects all the slots connected with this scope
+    void disconnect(const void *scope)
+    {
+        std::lock_guard<Mutex> lock(mutex_);
+        for (auto &body : *slots_)
+        {
+            if (body->scope == scope)
+                body->connected = false;
+        }
+
+        slots_ = this->copyConnectedSlots();
+    }
+
+    void disconnect_all_slots()
+    {
+        std::lock_guard<Mutex> lock(mutex_);
+        for (auto &body : *slots_)
+        {
+            body->connected = false;
+        }
+
+        slots_ = std::make_shared<SlotList>();
+    }
+
+    std::size_t num_slots() const
+    {
+        std::lock_guard<Mutex> lock(mutex_);
+        std::size_t count = 0;
+        for (auto &body : *slots_)
+        {
+            if (body->connected)
+                count++;
+        }
+
+        return count;
+    }
+
+    bool empty() const
+    {
+        return this->num_slots() == 0;
+    }
+
+private:
+    typedef light_signal_detail::SlotBody<slot_function_type> Body;
+
+    // replaced (copy on write) on each connection, the invocations in progress keep the version they took
+    typedef boost::container::small_vector<std::shared_ptr<Body>, InlineSlots> SlotList;
+
+    // mutex_ locked, the disconnected slots are dropped
+    std::shared_ptr<SlotList> copyConnectedSlots() const
+    {
+        auto slots = std::make_shared<SlotList>();
+        for (auto &body : *slots_)
+        {
+            if (body->connected)
+                slots->push_back(body);
+        }
+
+        return slots;
+    }
+
+    mutable Mutex mutex_;
+
+    std::shared_ptr<SlotList> slots_;
+};
+} // namespace smacc
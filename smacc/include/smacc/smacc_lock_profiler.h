@@ -0,0 +1,155 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace smacc
+{
+struct LockSiteStatistics
+{
+    std::string name;
+
+    unsigned long acquisitions;
+    // acquisitions that had to wait for other thread
+    unsigned long contentions;
+
+    double totalWaitSeconds;
+    double totalHoldSeconds;
+    double maxHoldSeconds;
+};
+
+// Counters of a place of the code that locks a ProfiledMutex. Sites are static objects (see SMACC_LOCK_SITE) that
+// are registered on construction and never destroyed.
+class LockSite
+{
+public:
+    explicit LockSite(const char *name);
+
+    LockSite(const LockSite &) = delete;
+    LockSite &operator=(const LockSite &) = delete;
+
+    void addAcquisition(bool contended, std::chrono::steady_clock::duration wait);
+
+    void addHold(std::chrono::steady_clock::duration hold);
+
+    LockSiteStatistics getStatistics() const;
+
+private:
+    const char *name_;
+
+    std::atomic<unsigned long> acquisitions_;
+    std::atomic<unsigned long> contentions_;
+
+    // nanoseconds
+    std::atomic<unsigned long> totalWait_;
+    std::atomic<unsigned long> totalHold_;
+    std::atomic<unsigned long> maxHold_;
+};
+
+// The profiling is disabled by default (the state machine enables it with the ros param ~lock_profiling). When it
+// is disabled the profiled mutexes only add a counter increment to the lock and unlock operations.
+void setLockProfilingEnabled(bool enabled);
+
+bool isLockProfilingEnabled();
+
+// statistics of all the sites (sites with the same name are merged), sorted by total hold time
+std::vector<LockSiteStatistics> getLockStatistics();
+
+// prints the statistics of the sites that were used with ROS_INFO
+void reportLockStatistics();
+
+namespace lock_profiler_detail
+{
+extern std::atomic<bool> enabled;
+} // namespace lock_profiler_detail
+
+// Mutex that measures the wait and hold times of each lock site. The hold time of a recursive mutex is measured
+// from the outermost lock to the outermost unlock and assigned to the site of the outermost lock.
+template <typename TMutex>
+class ProfiledMutex
+{
+public:
+    ProfiledMutex() : depth_(0), holdSite_(nullptr) {}
+
+    ProfiledMutex(const ProfiledMutex &) = delete;
+    ProfiledMutex &operator=(const ProfiledMutex &) = delete;
+
+    void lock(LockSite &site)
+    {
+        if (!lock_profiler_detail::enabled.load(std::memory_order_relaxed))
+        {
+            mutex_.lock();
+            if (depth_++ == 0)
+                holdSite_ = nullptr;
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        bool contended = !mutex_.try_lock();
+        if (contended)
+            mutex_.lock();
+
+        auto acquired = std::chrono::steady_clock::now();
+        if (depth_++ == 0)
+        {
+            holdSite_ = &site;
+            holdStart_ = acquired;
+        }
+
+        site.addAcquisition(contended, acquired - start);
+    }
+
+    void unlock()
+    {
+        if (--depth_ == 0 && holdSite_ != nullptr)
+        {
+            holdSite_->addHold(std::chrono::steady_clock::now() - holdStart_);
+        }
+
+        mutex_.unlock();
+    }
+
+private:
+    TMutex mutex_;
+
+    // only accessed by the thread that holds mutex_
+    unsigned int depth_;
+    LockSite *holdSite_;
+    std::chrono::steady_clock::time_point holdStart_;
+};
+
+template <typename TMutex>
+class ProfiledLockGuard
+{
+public:
+    ProfiledLockGuard(ProfiledMutex<TMutex> &mutex, LockSite &site) : mutex_(mutex)
+    {
+        mutex_.lock(site);
+    }
+
+    ~ProfiledLockGuard()
+    {
+        mutex_.unlock();
+    }
+
+    ProfiledLockGuard(const ProfiledLockGuard &) = delete;
+    ProfiledLockGuard &operator=(const ProfiledLockGuard &) = delete;
+
+private:
+    ProfiledMutex<TMutex> &mutex_;
+};
+} // namespace smacc
+
+// static lock site of the calling code, ie: ProfiledLockGuard<std::mutex> lock(mutex_, SMACC_LOCK_SITE("my site"));
+#define SMACC_LOCK_SITE(name)                                     \
+    ([]() -> smacc::LockSite & {                                  \
+        static smacc::LockSite *site = new smacc::LockSite(name); \
+        return *site;                                             \
+    }())
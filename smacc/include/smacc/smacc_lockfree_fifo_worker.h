@@ -0,0 +1,280 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#pragma once
+
+#include <boost/function.hpp>
+#include <boost/bind/bind.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace smacc
+{
+// Drop-in replacement of boost::statechart::fifo_worker (it can be used as the FifoWorker template parameter of
+// boost::statechart::fifo_scheduler). Producers (ros callbacks, async behaviors, the signal detector) enqueue work
+// items into a bounded multi-producer/single-consumer ring without taking any lock. The consumer (the state machine
+// thread) only blocks on a condition variable when the queue is empty.
+//
+// If the ring is full the items are not lost nor the producer blocked: they are stored into a (locked) overflow list
+// until the consumer catches up. This is important because the state machine thread is also a producer (ie: onEntry
+// posting events) and it cannot wait for itself.
+template <class Allocator = std::allocator<void>, std::size_t Capacity = 1024>
+class SmaccLockFreeFifoWorker : boost::noncopyable
+{
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "The fifo worker capacity must be a power of two");
+
+public:
+  typedef boost::function0<void> work_item;
+
+  SmaccLockFreeFifoWorker(bool waitOnEmptyQueue = false)
+      : cells_(Capacity),
+        enqueuePos_(0),
+        dequeuePos_(0),
+        overflowActive_(false),
+        consumerWaiting_(false),
+        overflowCount_(0),
+        waitOnEmptyQueue_(waitOnEmptyQueue),
+        terminated_(false)
+  {
+    for (std::size_t i = 0; i < Capacity; i++)
+    {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  void queue_work_item(work_item &item)
+  {
+    if (item.empty())
+    {
+      return;
+    }
+
+    if (!overflowActive_.load(std::memory_order_acquire) && tryPush(item))
+    {
+      notifyConsumer();
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(overflowMutex_);
+
+      // the consumer may have drained the overflow list meanwhile, in that case the ring is tried again
+      if (overflowActive_.load(std::memory_order_acquire) || !tryPush(item))
+      {
+        overflowActive_.store(true, std::memory_order_release);
+        overflow_.push_back(work_item());
+        overflow_.back().swap(item);
+        overflowCount_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    notifyConsumer();
+  }
+
+  void queue_work_item(const work_item &item)
+  {
+    work_item copy = item;
+    queue_work_item(copy);
+  }
+
+  void terminate()
+  {
+    work_item item = boost::bind(&SmaccLockFreeFifoWorker::terminate_impl, this);
+    queue_work_item(item);
+  }
+
+  bool terminated() const
+  {
+    return terminated_;
+  }
+
+  // number of work items that did not fit into the ring since the worker was created
+  unsigned long getOverflowCount() const
+  {
+    return overflowCount_.load(std::memory_order_relaxed);
+  }
+
+  unsigned long operator()(unsigned long maxItemCount = 0)
+  {
+    unsigned long itemCount = 0;
+
+    while (!terminated() &&
+           ((maxItemCount == 0) || (itemCount < maxItemCount)))
+    {
+      work_item item = dequeue_item();
+
+      if (item.empty())
+      {
+        return itemCount;
+      }
+
+      item();
+      ++itemCount;
+    }
+
+    return itemCount;
+  }
+
+private:
+  struct Cell
+  {
+    std::atomic<std::size_t> sequence;
+    work_item item;
+  };
+
+  // Vyukov's bounded queue algorithm, producer side
+  bool tryPush(work_item &item)
+  {
+    std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      Cell &cell = cells_[pos & (Capacity - 1)];
+      std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+      intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+      if (diff == 0)
+      {
+        if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          cell.item.swap(item);
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (diff < 0)
+      {
+        // full
+        return false;
+      }
+      else
+      {
+        pos = enqueuePos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // single consumer side, only called from the state machine thread
+  bool tryPop(work_item &item)
+  {
+    std::size_t pos = dequeuePos_;
+    Cell &cell = cells_[pos & (Capacity - 1)];
+    std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+
+    if ((intptr_t)seq - (intptr_t)(pos + 1) < 0)
+    {
+      // empty
+      return false;
+    }
+
+    item.swap(cell.item);
+    cell.sequence.store(pos + Capacity, std::memory_order_release);
+    dequeuePos_ = pos + 1;
+    return true;
+  }
+
+  bool tryPopOverflow(work_item &item)
+  {
+    if (!overflowActive_.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+
+    std::lock_guard<std::mutex> lock(overflowMutex_);
+
+    // the ring items are older than the overflow ones, check again after stopping the overflow producers
+    if (tryPop(item))
+    {
+      return true;
+    }
+
+    if (overflow_.empty())
+    {
+      overflowActive_.store(false, std::memory_order_release);
+      return false;
+    }
+
+    item.swap(overflow_.front());
+    overflow_.pop_front();
+    return true;
+  }
+
+  work_item dequeue_item()
+  {
+    work_item result;
+    if (tryPop(result) || tryPopOverflow(result) || !waitOnEmptyQueue_)
+    {
+      return result;
+    }
+
+    // short spin before blocking, events usually come in bursts
+    for (int i = 0; i < 64; i++)
+    {
+      std::this_thread::yield();
+      if (tryPop(result) || tryPopOverflow(result))
+      {
+        return result;
+      }
+    }
+
+    std::unique_lock<std::mutex> lock(waitMutex_);
+    for (;;)
+    {
+      consumerWaiting_.store(true, std::memory_order_seq_cst);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      if (tryPop(result) || tryPopOverflow(result))
+      {
+        consumerWaiting_.store(false, std::memory_order_relaxed);
+        return result;
+      }
+
+      queueNotEmpty_.wait(lock);
+    }
+  }
+
+  void notifyConsumer()
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (consumerWaiting_.load(std::memory_order_seq_cst))
+    {
+      std::lock_guard<std::mutex> lock(waitMutex_);
+      consumerWaiting_.store(false, std::memory_order_relaxed);
+      queueNotEmpty_.notify_one();
+    }
+  }
+
+  void terminate_impl()
+  {
+    terminated_ = true;
+  }
+
+  std::vector<Cell> cells_;
+
+  // producer and consumer indexes are kept in different cache lines
+  alignas(64) std::atomic<std::size_t> enqueuePos_;
+  alignas(64) std::size_t dequeuePos_;
+
+  alignas(64) std::atomic<bool> overflowActive_;
+  std::mutex overflowMutex_;
+  std::deque<work_item> overflow_;
+
+  std::atomic<bool> consumerWaiting_;
+  std::mutex waitMutex_;
+  std::condition_variable queueNotEmpty_;
+
+  std::atomic<unsigned long> overflowCount_;
+
+  const bool waitOnEmptyQueue_;
+
+  bool terminated_;
+};
+} // namespace smacc
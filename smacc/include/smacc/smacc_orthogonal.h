@@ -6,6 +6,7 @@
 
 #pragma once
 #include <smacc/common.h>
+#include <smacc/smacc_type_index.h>
 #include <utility>
 
 namespace smacc
@@ -54,6 +55,9 @@ protected:
 
     std::vector<std::shared_ptr<smacc::ISmaccClient>> clients_;
 
+    // the same clients indexed by their type for constant time requiresClient calls
+    TypeIndexedRegistry<ISmaccClient> clientIndex_;
+
 private:
     ISmaccStateMachine *stateMachine_;
 
@@ -0,0 +1,185 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace smacc
+{
+struct SmaccPoolStatistics
+{
+  // allocations served from the pool
+  unsigned long hits;
+  // allocations that had to go to the heap (pool empty or array allocations)
+  unsigned long misses;
+  // free objects currently kept by the pool(s)
+  unsigned long cached;
+};
+
+namespace pool_detail
+{
+// maximum number of free objects kept for each type, the rest are returned to the heap
+const std::size_t MAX_CACHED_OBJECTS = 1024;
+
+struct FreeNode
+{
+  FreeNode *next;
+};
+
+struct FreeList
+{
+  FreeList() : head(nullptr), cached(0), hits(0), misses(0) {}
+
+  std::mutex mutex;
+  FreeNode *head;
+  std::size_t cached;
+
+  std::atomic<unsigned long> hits;
+  std::atomic<unsigned long> misses;
+};
+
+// aggregated counters of all the pools, defined in smacc_pool_allocator.cpp
+extern std::atomic<unsigned long> totalHits;
+extern std::atomic<unsigned long> totalMisses;
+extern std::atomic<long> totalCached;
+
+template <typename T>
+FreeList &getFreeList()
+{
+  // intentionally leaked: events and states may still be released during the static destruction
+  static FreeList *freeList = new FreeList();
+  return *freeList;
+}
+
+template <typename T>
+constexpr std::size_t blockSize()
+{
+  return sizeof(T) > sizeof(FreeNode) ? sizeof(T) : sizeof(FreeNode);
+}
+} // namespace pool_detail
+
+// Stateless allocator that keeps a free list for each allocated type. It is used as the SmaccAllocator of the
+// state machine (states, internal lists of boost statechart and the event queue nodes) and of the smacc
+// default events, so that once the pools are warmed up, posting events and doing transitions do not touch the heap.
+// Objects allocated from one thread (ie: ros callbacks) can be released from other (the state machine thread).
+template <typename T>
+class SmaccPoolAllocator
+{
+public:
+  typedef T value_type;
+
+  template <typename U>
+  struct rebind
+  {
+    typedef SmaccPoolAllocator<U> other;
+  };
+
+  SmaccPoolAllocator() noexcept {}
+
+  template <typename U>
+  SmaccPoolAllocator(const SmaccPoolAllocator<U> &) noexcept {}
+
+  T *allocate(std::size_t n, const void * /*hint*/ = 0)
+  {
+    auto &freeList = pool_detail::getFreeList<T>();
+    if (n == 1)
+    {
+      std::lock_guard<std::mutex> lock(freeList.mutex);
+      if (freeList.head != nullptr)
+      {
+        auto *node = freeList.head;
+        freeList.head = node->next;
+        freeList.cached--;
+
+        freeList.hits.fetch_add(1, std::memory_order_relaxed);
+        pool_detail::totalHits.fetch_add(1, std::memory_order_relaxed);
+        pool_detail::totalCached.fetch_sub(1, std::memory_order_relaxed);
+        return reinterpret_cast<T *>(node);
+      }
+    }
+
+    freeList.misses.fetch_add(1, std::memory_order_relaxed);
+    pool_detail::totalMisses.fetch_add(1, std::memory_order_relaxed);
+
+    if (n == 1)
+      return static_cast<T *>(::operator new(pool_detail::blockSize<T>()));
+    else
+      return static_cast<T *>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T *p, std::size_t n)
+  {
+    if (n == 1)
+    {
+      auto &freeList = pool_detail::getFreeList<T>();
+      std::lock_guard<std::mutex> lock(freeList.mutex);
+      if (freeList.cached < pool_detail::MAX_CACHED_OBJECTS)
+      {
+        auto *node = reinterpret_cast<pool_detail::FreeNode *>(p);
+        node->next = freeList.head;
+        freeList.head = node;
+        freeList.cached++;
+        pool_detail::totalCached.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+    }
+
+    ::operator delete(p);
+  }
+
+  // preallocates objects so that the first posted events of this type are already pool hits
+  static void reserve(std::size_t count)
+  {
+    auto &freeList = pool_detail::getFreeList<T>();
+    std::lock_guard<std::mutex> lock(freeList.mutex);
+    while (freeList.cached < count && freeList.cached < pool_detail::MAX_CACHED_OBJECTS)
+    {
+      auto *node = static_cast<pool_detail::FreeNode *>(::operator new(pool_detail::blockSize<T>()));
+      node->next = freeList.head;
+      freeList.head = node;
+      freeList.cached++;
+      pool_detail::totalCached.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  static SmaccPoolStatistics getStatistics()
+  {
+    auto &freeList = pool_detail::getFreeList<T>();
+    std::lock_guard<std::mutex> lock(freeList.mutex);
+    return SmaccPoolStatistics{freeList.hits.load(std::memory_order_relaxed),
+                               freeList.misses.load(std::memory_order_relaxed), freeList.cached};
+  }
+};
+
+template <typename T, typename U>
+bool operator==(const SmaccPoolAllocator<T> &, const SmaccPoolAllocator<U> &)
+{
+  return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const SmaccPoolAllocator<T> &, const SmaccPoolAllocator<U> &)
+{
+  return false;
+}
+
+// statistics of all the pools together
+SmaccPoolStatistics getPoolStatistics();
+
+// statistics of the pool of some specific event or state type (ie: getPoolStatistics<EvTopicMessage<...>>())
+template <typename T>
+SmaccPoolStatistics getPoolStatistics()
+{
+  return SmaccPoolAllocator<T>::getStatistics();
+}
+} // namespace smacc
+
+// Allocator of the state machine, its event queue and the smacc default events. User events can also be pooled
+// declaring them as: struct EvMyEvent : sc::event<EvMyEvent, SmaccAllocator>
+typedef smacc::SmaccPoolAllocator<void> SmaccAllocator;
@@ -9,12 +9,15 @@
 #include <boost/signals2/signal.hpp>
 #include <boost/any.hpp>
 
+#include <utility>
+
 namespace smacc
 {
 using namespace boost;
 using namespace boost::signals2;
 using namespace boost::signals2::detail;
 
+// thread safe signal (boost::signals2), see SmaccLightSignal (smacc_light_signal.h) for the hot callback paths
 template <typename Signature,
           typename Combiner = optional_last_value<typename boost::function_traits<Signature>::result_type>,
           typename Group = int,
@@ -25,4 +28,9 @@ template <typename Signature,
 class SmaccSignal : public boost::signals2::signal<Signature, Combiner, Group, GroupCompare, SlotFunction, ExtendedSlotFunction, Mutex>
 {
 };
+
+// connection returned by the connect method of a signal (boost::signals2::connection, SmaccLightConnection)
+template <typename TSignal>
+using SignalConnection =
+    decltype(std::declval<TSignal &>().connect(std::declval<typename TSignal::slot_function_type>()));
 } // namespace smacc
\ No newline at end of file
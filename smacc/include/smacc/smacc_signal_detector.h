@@ -7,7 +7,9 @@
 
 #include <boost/thread.hpp>
 #include <smacc/common.h>
+#include <smacc/smacc_thread_pool.h>
 #include <atomic>
+#include <mutex>
 
 namespace smacc
 {
@@ -32,6 +34,21 @@ public:
 
     void pollOnce();
 
+    // in event driven mode, it forces a new poll before the next update deadline (ie: a new state was entered)
+    void wakeUp();
+
+    // Index of the updatable elements. They are registered when they are created so that the polling loop iterates
+    // a prebuilt list (no searches nor dynamic casts). Clients and components live during the whole state machine life.
+    void registerUpdatableClient(ISmaccUpdatable *updatable);
+
+    // Client behaviors (without owner state), states, state reactors and event generators. The elements with
+    // owner state are only updated while their owner is the current state.
+    void registerUpdatableStateElement(ISmaccUpdatable *updatable, ISmaccState *ownerState);
+
+    void unregisterUpdatableStateElement(ISmaccUpdatable *updatable);
+
+    void unregisterUpdatableStateElements(ISmaccState *ownerState);
+
     template <typename EventType>
     void postEvent(EventType *ev)
     {
@@ -39,21 +56,54 @@ public:
         this->scheduler_->queue_event(processorHandle_, weakPtrEvent);
     }
 
+    void postEvent(const boost::intrusive_ptr<const boost::statechart::event_base> &ev)
+    {
+        this->scheduler_->queue_event(processorHandle_, ev);
+    }
+
 private:
     ISmaccStateMachine *smaccStateMachine_;
 
+    // registered updatable elements (modified from the state machine thread)
+    std::mutex updatablesMutex_;
+
+    std::vector<ISmaccUpdatable *> registeredClients_;
+
+    std::vector<std::pair<ISmaccUpdatable *, ISmaccState *>> registeredStateElements_;
+
+    std::atomic<bool> updatableClientsChanged_;
+
+    std::atomic<bool> updatableStateElementsChanged_;
+
+    // lists iterated by the polling loop, they are only rebuilt when the registered elements change
     std::vector<ISmaccUpdatable *> updatableClients_;
 
     std::vector<ISmaccUpdatable *> updatableStateElements_;
 
     std::atomic<unsigned long> lastState_;
 
-    void findUpdatableClients();
-    void findUpdatableStateElements(ISmaccState* currentState);
+    void refreshUpdatableClients();
+    void refreshUpdatableStateElements(ISmaccState* currentState);
+
+    void updateElement(ISmaccUpdatable *updatable, const ros::Time &now, bool loopTick);
+
+    void dispatchUpdate(ISmaccUpdatable *updatable, const ros::Time &now);
+
+    // executes the updates of the thread safe updatables (ros param ~signal_detector_thread_pool_size, 0 to disable)
+    std::unique_ptr<SmaccThreadPool> threadPool_;
 
     // Loop frequency of the signal detector (to check answers from actionservers)
     double loop_rate_hz;
 
+    // When it is enabled (ros param ~signal_detector_event_driven) the signal detector does not poll at a fixed rate.
+    // It sleeps until the earliest update deadline of the updatable elements, a ros callback or a wake up request.
+    // Updatables without update period nor deadline are still updated at loop_rate_hz.
+    std::atomic<bool> eventDriven_;
+
+    ros::Time nextDeadline_;
+
+    ros::Time nextLoopTick_;
+
     std::atomic<bool> end_;
 
     std::atomic<bool> initialized_;
@@ -95,7 +145,7 @@ void run()
     scheduler1.initiate_processor(sm);
 
     //create a thread for the asynchronous state machine processor execution
-    boost::thread otherThread(boost::bind(&sc::fifo_scheduler<>::operator(), &scheduler1, 0));
+    boost::thread otherThread(boost::bind(&SmaccFifoScheduler::operator(), &scheduler1, 0));
 
     // use the  main thread for the signal detector component (waiting actionclient requests)
     signalDetector.pollingLoop();
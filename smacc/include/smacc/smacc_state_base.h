@@ -48,7 +48,7 @@ namespace smacc
 
     SmaccState() = delete;
 
-#define STATE_NAME (demangleSymbol(typeid(MostDerived).name()).c_str())
+#define STATE_NAME (demangleType(typeid(MostDerived)).c_str())
     // Constructor that initializes the state ros node handle
     SmaccState(my_context ctx)
     {
@@ -56,7 +56,7 @@ namespace smacc
 
       static_assert(!std::is_same<MostDerived, Context>::value, "The context must be a different state or state machine than the current state");
 
-      ROS_WARN("[%s] creating ", STATE_NAME);
+      SMACC_TRACE_INFO("[%s] creating ", STATE_NAME);
       this->set_context(ctx.pContext_);
 
       this->stateInfo_ = getStateInfo();
@@ -67,7 +67,7 @@ namespace smacc
       finishStateThrown = false;
 
       this->contextNh = optionalNodeHandle(ctx.pContext_);
-      ROS_DEBUG("[%s] Ros node handle namespace for this state: %s", STATE_NAME, contextNh.getNamespace().c_str());
+      SMACC_TRACE_DEBUG("[%s] Ros node handle namespace for this state: %s", STATE_NAME, contextNh.getNamespace().c_str());
       if (contextNh.getNamespace() == "/")
       {
         auto nhname = smacc::utils::cleanShortTypeName(typeid(Context));
@@ -82,12 +82,12 @@ namespace smacc
 
     const smacc::introspection::SmaccStateInfo *getStateInfo()
     {
-      auto smInfo = this->getStateMachine().getStateMachineInfo();
+      auto &smInfo = this->getStateMachine().getStateMachineInfo();
 
-      auto key = typeid(MostDerived).name();
-      if (smInfo.states.count(key))
+      auto it = smInfo.states.find(typeid(MostDerived).name());
+      if (it != smInfo.states.end())
       {
-        return smInfo.states[key].get();
+        return it->second.get();
       }
       else
       {
@@ -95,12 +95,12 @@ namespace smacc
       }
     }
 
-    std::string getFullName()
+    const std::string &getFullName()
     {
-      return demangleSymbol(typeid(MostDerived).name());
+      return demangleType(typeid(MostDerived));
     }
 
-    std::string getShortName()
+    const std::string &getShortName()
     {
       return smacc::utils::cleanShortTypeName(typeid(MostDerived));
     }
@@ -320,7 +320,7 @@ namespace smacc
       {
         this->postEvent<EvLoopEnd<MostDerived>>();
       }
-      ROS_INFO("[%s] POST THROW CONDITION", STATE_NAME);
+      SMACC_TRACE_INFO("[%s] POST THROW CONDITION", STATE_NAME);
     }
 
     void throwSequenceFinishedEvent()
@@ -364,7 +364,7 @@ namespace smacc
       auto state = new MostDerived(SmaccState<MostDerived, Context, InnerInitial, historyMode>::my_context(pContext));
       const inner_context_ptr_type pInnerContext(state);
 
-      ROS_INFO("[%s] State object created. Initializating...", STATE_NAME);
+      SMACC_TRACE_INFO("[%s] State object created. Initializating...", STATE_NAME);
       state->entryStateInternal();
 
       outermostContextBase.add(pInnerContext);
@@ -375,7 +375,7 @@ namespace smacc
     template <typename TOrthogonal, typename TBehavior>
     static void configure_orthogonal_internal(std::function<void(ISmaccState *state)> initializationFunction)
     {
-      ROS_INFO("[%s] Runtime configure orthogonal %s -> %s", STATE_NAME, demangleSymbol(typeid(TOrthogonal).name()).c_str(), demangleSymbol(typeid(TBehavior).name()).c_str());
+      ROS_INFO("[%s] Runtime configure orthogonal %s -> %s", STATE_NAME, demangleType(typeid(TOrthogonal)).c_str(), demangleType(typeid(TBehavior)).c_str());
 
       ClientBehaviorInfoEntry bhinfo;
       bhinfo.factoryFunction = initializationFunction;
@@ -397,22 +397,24 @@ namespace smacc
       // TODO: make this static to build the parameter tree at startup
       this->nh = ros::NodeHandle(contextNh.getNamespace() + std::string("/") + smacc::utils::cleanShortTypeName(typeid(MostDerived)).c_str());
 
-      ROS_DEBUG("[%s] nodehandle namespace: %s", STATE_NAME, nh.getNamespace().c_str());
+      SMACC_TRACE_DEBUG("[%s] nodehandle namespace: %s", STATE_NAME, nh.getNamespace().c_str());
 
       this->setParam("created", true);
 
       // before dynamic runtimeConfigure, we execute the staticConfigure behavior configurations
       {
-        ROS_INFO("[%s] -- STATIC STATE DESCRIPTION --", STATE_NAME);
+        SMACC_TRACE_INFO("[%s] -- STATIC STATE DESCRIPTION --", STATE_NAME);
 
+#if SMACC_TRACING
         for (const auto &stateReactorsVector : SmaccStateInfo::staticBehaviorInfo)
         {
-          ROS_DEBUG("[%s] state info: %s", STATE_NAME, demangleSymbol(stateReactorsVector.first->name()).c_str());
+          SMACC_TRACE_DEBUG("[%s] state info: %s", STATE_NAME, demangleType(stateReactorsVector.first).c_str());
           for (auto &bhinfo : stateReactorsVector.second)
           {
-            ROS_DEBUG("[%s] client behavior: %s", STATE_NAME, demangleSymbol(bhinfo.behaviorType->name()).c_str());
+            SMACC_TRACE_DEBUG("[%s] client behavior: %s", STATE_NAME, demangleType(bhinfo.behaviorType).c_str());
           }
         }
+#endif
 
         const std::type_info *tindex = &(typeid(MostDerived));
         auto &staticDefinedBehaviors = SmaccStateInfo::staticBehaviorInfo[tindex];
@@ -421,26 +423,26 @@ namespace smacc
 
         for (auto &bhinfo : staticDefinedBehaviors)
         {
-          ROS_INFO("[%s] Creating static client behavior: %s", STATE_NAME, demangleSymbol(bhinfo.behaviorType->name()).c_str());
+          SMACC_TRACE_INFO("[%s] Creating static client behavior: %s", STATE_NAME, demangleType(bhinfo.behaviorType).c_str());
           bhinfo.factoryFunction(this);
         }
 
         for (auto &sr : staticDefinedStateReactors)
         {
-          ROS_INFO("[%s] Creating static state reactor: %s", STATE_NAME, demangleSymbol(sr->stateReactorType->name()).c_str());
+          SMACC_TRACE_INFO("[%s] Creating static state reactor: %s", STATE_NAME, demangleType(sr->stateReactorType).c_str());
           sr->factoryFunction(this);
         }
 
         for (auto &eg : staticDefinedEventGenerators)
         {
-          ROS_INFO("[%s] Creating static event generator: %s", STATE_NAME, demangleSymbol(eg->eventGeneratorType->name()).c_str());
+          SMACC_TRACE_INFO("[%s] Creating static event generator: %s", STATE_NAME, demangleType(eg->eventGeneratorType).c_str());
           eg->factoryFunction(this);
         }
 
-        ROS_INFO("[%s] ---- END STATIC DESCRIPTION", STATE_NAME);
+        SMACC_TRACE_INFO("[%s] ---- END STATIC DESCRIPTION", STATE_NAME);
       }
 
-      ROS_INFO("[%s] State runtime configuration", STATE_NAME);
+      SMACC_TRACE_INFO("[%s] State runtime configuration", STATE_NAME);
 
       auto *derivedthis = static_cast<MostDerived *>(this);
 
@@ -452,7 +454,7 @@ namespace smacc
 
       this->getStateMachine().notifyOnRuntimeConfigurationFinished(derivedthis);
 
-      ROS_INFO("[%s] State OnEntry", STATE_NAME);
+      SMACC_TRACE_INFO("[%s] State OnEntry", STATE_NAME);
 
       // finally we go to the derived state onEntry Function
       static_cast<MostDerived *>(this)->onEntry();
@@ -6,18 +6,31 @@
 #pragma once
 
 #include <boost/any.hpp>
+#include <atomic>
+#include <functional>
+#include <list>
 #include <map>
+#include <memory>
 #include <mutex>
 
 #include <smacc/common.h>
 #include <smacc/introspection/introspection.h>
 #include <smacc/introspection/smacc_state_machine_info.h>
 #include <smacc/smacc_updatable.h>
+#include <smacc/smacc_type_index.h>
 #include <smacc/smacc_signal.h>
+#include <smacc/smacc_light_signal.h>
+#include <smacc/smacc_global_data.h>
+#include <smacc/smacc_lock_profiler.h>
+#include <smacc/smacc_deferred_event_queue.h>
+#include <smacc/smacc_thread_pool.h>
+#include <smacc/smacc_transition_log.h>
 
 #include <smacc_msgs/SmaccStateMachine.h>
+#include <smacc_msgs/SmaccHeartbeat.h>
 #include <smacc_msgs/SmaccTransitionLogEntry.h>
 #include <smacc_msgs/SmaccStatus.h>
+#include <smacc_msgs/SmaccStatusDelta.h>
 #include <smacc_msgs/SmaccGetTransitionHistory.h>
 
 #include <smacc/smacc_state.h>
@@ -34,6 +47,42 @@ enum class EventLifeTime{
     CURRENT_STATE /*events are discarded if we are leaving the state it were created. I is used for client behaviors whose liftime is associated to state*/
 };
 
+// internal event that executes a function in the state machine thread (see runOnStateMachineThread). It is not
+// notified to the state reactors nor processed by the states.
+struct EvStateMachineTask : sc::event<EvStateMachineTask, SmaccAllocator>
+{
+    std::function<void()> task;
+};
+
+struct OrthogonalLatencyStatistics
+{
+    std::string orthogonal;
+
+    unsigned long entries;
+    double lastEntrySeconds;
+    double maxEntrySeconds;
+    double totalEntrySeconds;
+
+    unsigned long exits;
+    double lastExitSeconds;
+    double maxExitSeconds;
+    double totalExitSeconds;
+};
+
+// time that the transitions waited for the asynchronous client behaviors to finish (SmaccAsyncClientBehavior::dispose)
+struct AsyncBehaviorExitStatistics
+{
+    std::string behavior;
+
+    unsigned long exits;
+    double lastDelaySeconds;
+    double maxDelaySeconds;
+    double totalDelaySeconds;
+
+    // exits where the behavior did not finish in the exit deadline and it was detached
+    unsigned long expiredDeadlines;
+};
+
 enum class StateMachineInternalAction
 {
     STATE_CONFIGURING,
@@ -67,27 +116,82 @@ public:
     template <typename SmaccComponentType>
     void requiresComponent(SmaccComponentType *&storage);
 
+    // type indexed registry of the clients and components of all the orthogonals, they are registered when created.
+    // orthogonalKey is the key of the orthogonal in orthogonals_ and clientIndex the position of the client (or the
+    // owner client of the component) in the orthogonal
+    template <typename TClient>
+    void registerClient(TClient *client, const std::string &orthogonalKey, std::size_t clientIndex);
+
+    template <typename TComponent>
+    void registerComponent(TComponent *component, const std::string &orthogonalKey, std::size_t clientIndex);
+
+    template <typename TClient>
+    TClient *findClient();
+
     template <typename EventType>
     void postEvent(EventType *ev, EventLifeTime evlifetime = EventLifeTime::ABSOLUTE);
 
     template <typename EventType>
     void postEvent(EventLifeTime evlifetime = EventLifeTime::ABSOLUTE);
 
+    // queues the function so that it is executed by the state machine thread, in order with the events. It can be
+    // called from any thread (ie: to resume the coroutine client behaviors from the ros callbacks)
+    void runOnStateMachineThread(std::function<void()> task);
+
     void getTransitionLogHistory();
 
+    // counters of the current state scoped events posted during the transitions
+    DeferredEventStatistics getDeferredEventStatistics() const;
+
+    // duration of the onEntry/onExit of each orthogonal (its client behaviors)
+    std::vector<OrthogonalLatencyStatistics> getOrthogonalLatencyStatistics();
+
+    std::vector<AsyncBehaviorExitStatistics> getAsyncBehaviorExitStatistics();
+
+    void addAsyncBehaviorExitDelay(const std::string &behavior, double seconds, bool deadlineExpired);
+
+    // maximum time that a transition waits for each asynchronous client behavior (ros param
+    // ~async_behavior_exit_deadline in seconds, 0 means no deadline)
+    inline ros::Duration getAsyncBehaviorExitDeadline() const { return asyncBehaviorExitDeadline_; }
+
     template <typename T>
     bool getGlobalSMData(std::string name, T &ret);
 
+    // The value is only stringified for the status messages (by the status delta timer), so setting it is cheap.
     template <typename T>
     void setGlobalSMData(std::string name, T value);
 
+    // Typed access to the global variables. The key is obtained once (ie: in onInitialize) and then the reads and
+    // writes through it do not take any lock nor look up the name.
+    template <typename T>
+    GlobalDataKey<T> getGlobalDataKey(std::string name);
+
+    // returns the current value without copying it (null if it was not set or it has other type)
+    template <typename T>
+    std::shared_ptr<const T> getGlobalSMData(const GlobalDataKey<T> &key);
+
+    template <typename T>
+    void setGlobalSMData(const GlobalDataKey<T> &key, T value);
+
+    // the callback is called from the thread that sets the variable
+    template <typename T>
+    boost::signals2::connection onGlobalSMDataChanged(const GlobalDataKey<T> &key, std::function<void(const T &)> callback);
+
+    // limits how often a variable is sent in the status delta topic (0 means every status delta timer tick).
+    // The default is the ros param ~global_data_max_publish_rate
+    void setGlobalSMDataMaxPublishRate(std::string name, double hz);
+
     template <typename StateField, typename BehaviorType>
     void mapBehavior();
 
     std::string getStateMachineName();
 
+    // publishes the heartbeat (the state machine description is only published once, on a latched topic)
     void state_machine_visualization(const ros::TimerEvent &);
 
+    // publishes the global variables changed since the last delta, and then the updated full (latched) status
+    void publishStatusDelta(const ros::TimerEvent &);
+
     inline std::shared_ptr<SmaccStateInfo> getCurrentStateInfo() { return currentStateInfo_; }
 
     void publishTransition(const SmaccTransitionInfo &transitionInfo);
@@ -97,8 +201,11 @@ public:
 
     bool getTransitionLogHistory(smacc_msgs::SmaccGetTransitionHistory::Request &req, smacc_msgs::SmaccGetTransitionHistory::Response &res);
 
+    // returns the connection type of the signal (boost::signals2::connection for SmaccSignal, SmaccLightConnection
+    // for SmaccLightSignal)
     template <typename TSmaccSignal, typename TMemberFunctionPrototype, typename TSmaccObjectType>
-    boost::signals2::connection createSignalConnection(TSmaccSignal &signal, TMemberFunctionPrototype callback, TSmaccObjectType *object);
+    SignalConnection<TSmaccSignal> createSignalConnection(TSmaccSignal &signal, TMemberFunctionPrototype callback,
+                                                          TSmaccObjectType *object);
 
     // template <typename TSmaccSignal, typename TMemberFunctionPrototype>
     // boost::signals2::connection createSignalConnection(TSmaccSignal &signal, TMemberFunctionPrototype callback);
@@ -134,10 +241,24 @@ public:
         return nh_;
     };
 
+    // updatable elements registration (see SignalDetector), nullptr values are ignored
+    void registerUpdatableClient(ISmaccUpdatable *updatable);
+
+    void registerUpdatableStateElement(ISmaccUpdatable *updatable, ISmaccState *ownerState);
+
+    void unregisterUpdatableStateElement(ISmaccUpdatable *updatable);
+
 
 protected:
     void checkStateMachineConsistence();
 
+    // notifies the event to the interested state reactors of the current state and its ancestors. It is called from
+    // the state machine thread just before the event is processed (see SmaccStateMachineBase::process_event_impl)
+    void notifyStateReactors(const boost::statechart::event_base &ev);
+
+    // executes an EvStateMachineTask (see SmaccStateMachineBase::process_event_impl)
+    void runStateMachineTask(const EvStateMachineTask &ev);
+
     void initializeROS(std::string smshortname);
 
     void onInitialized();
@@ -162,8 +283,11 @@ protected:
     ros::NodeHandle private_nh_;
 
     ros::Timer timer_;
+    ros::Timer statusDeltaTimer_;
     ros::Publisher stateMachinePub_;
     ros::Publisher stateMachineStatusPub_;
+    ros::Publisher stateMachineStatusDeltaPub_;
+    ros::Publisher heartbeatPub_;
     ros::Publisher transitionLogPub_;
     ros::ServiceServer transitionHistoryService_;
 
@@ -178,32 +302,134 @@ protected:
     // orthogonals
     std::map<std::string, std::shared_ptr<smacc::ISmaccOrthogonal>> orthogonals_;
 
+    // orthogonals indexed by getTypeIndex<ISmaccOrthogonal, TOrthogonal>(). The table is replaced (copy on write) when
+    // an orthogonal is created, so getOrthogonal does not need any lock. The old versions are kept alive.
+    std::atomic<const std::vector<ISmaccOrthogonal *> *> orthogonalTable_;
+    std::list<std::unique_ptr<const std::vector<ISmaccOrthogonal *>>> orthogonalTableVersions_;
+
+    // if there are several clients or components of the same type, the lookups return the one of the first orthogonal
+    // by name (and the first client of that orthogonal), as the iteration of orthogonals_
+    TypeIndexedRegistry<ISmaccClient> clientRegistry_;
+    TypeIndexedRegistry<ISmaccComponent> componentRegistry_;
+
 private:
-    std::recursive_mutex m_mutex_;
-    std::recursive_mutex eventQueueMutex_;
+    // orthogonals_, the orthogonal table versions and the client/component registries
+    ProfiledMutex<std::recursive_mutex> structureMutex_;
+
+    // current state and its updatable elements. It is held by the signal detector while the updatables are updated and
+    // by the state machine from the exit of a state until it is destroyed
+    ProfiledMutex<std::recursive_mutex> updateMutex_;
+
+    // status_msg_ and the publication state of the global data
+    ProfiledMutex<std::mutex> statusMutex_;
+
+    // read by the signal detector and posting threads
+    std::atomic<StateMachineInternalAction> stateMachineCurrentAction;
+
+    // index of the current state in the description (-1 during transitions), for the heartbeat
+    std::atomic<int> currentStateIndex_;
+
+    // disconnected in bulk when the state exits (the capacity is kept for the next state)
+    std::vector<boost::signals2::connection> stateCallbackConnections;
+    std::vector<SmaccLightConnection> stateLightCallbackConnections_;
+
+    void addStateCallbackConnection(const boost::signals2::connection &connection);
+    void addStateCallbackConnection(const SmaccLightConnection &connection);
+
+    // client behaviors of different orthogonals may create connections concurrently (parallel orthogonals)
+    ProfiledMutex<std::mutex> stateCallbackConnectionsMutex_;
+
+    // Calls onEntry or onExit of all the orthogonals. If the ros param ~parallel_orthogonals is set (opt-in), they
+    // are executed concurrently in orthogonalThreadPool_ (~parallel_orthogonals_threads workers, 0 means one for each
+    // orthogonal) and this waits for all of them (join barrier), so the state reactors and event generators are still
+    // entered after the orthogonals and exited after them. The client behaviors of different orthogonals must not
+    // share unsynchronized data when this is enabled.
+    void executeOrthogonals(bool entry);
+
+    bool parallelOrthogonals_;
+
+    int parallelOrthogonalsThreads_;
+
+    // created on the first parallel execution
+    std::unique_ptr<SmaccThreadPool> orthogonalThreadPool_;
+
+    // the runtime statistics are logged when the state machine finishes (ros param ~print_statistics, opt-in)
+    bool printStatistics_;
 
-    StateMachineInternalAction stateMachineCurrentAction;
+    std::mutex orthogonalLatencyMutex_;
 
-    std::list<boost::signals2::connection> stateCallbackConnections;
+    std::map<std::string, OrthogonalLatencyStatistics> orthogonalLatency_;
+
+    ros::Duration asyncBehaviorExitDeadline_;
+
+    std::mutex asyncBehaviorExitMutex_;
+
+    std::map<std::string, AsyncBehaviorExitStatistics> asyncBehaviorExit_;
 
     // shared variables
-    std::map<std::string, std::pair<std::function<std::string()>, boost::any>> globalData_;
+    GlobalDataStore globalData_;
+
+    // publication state of each global variable, indexed as the slots of globalData_
+    struct GlobalDataStatus
+    {
+        GlobalDataStatus() : publishedVersion(0) {}
+
+        ros::Duration minPublishPeriod;
+        ros::Time lastPublished;
+
+        // version of the slot sent in the last status delta
+        uint64_t publishedVersion;
+    };
+
+    // adds the variables interned since the last call to globalDataStatus_ and to the global_variable_* fields of
+    // status_msg_ (statusMutex_ locked)
+    void updateGlobalDataStatus();
+
+    std::vector<GlobalDataStatus> globalDataStatus_;
 
-    std::vector<smacc_msgs::SmaccTransitionLogEntry> transitionLogHistory_;
+    ros::Duration globalDataMinPublishPeriod_;
+
+    uint64_t statusDeltaSequence_;
+
+    // content_hash of the published state machine description
+    uint64_t descriptionHash_;
+
+    // last transitions (ros params ~transition_log_capacity and ~transition_log_spill_file), created in initializeROS
+    std::unique_ptr<TransitionLog> transitionLog_;
 
     smacc::SMRunMode runMode_;
 
     // Event to notify to the signaldetection thread that a request has been created...
     SignalDetector *signalDetector_;
 
-    unsigned long stateSeqCounter_;
+    // read by the threads that post events (see postEvent)
+    std::atomic<unsigned long> stateSeqCounter_;
 
-    void lockStateMachine(std::string msg);
+    // true while a state is exiting or between the exit of a state and the entry of the next one
+    inline bool isTransitioning() const
+    {
+        auto action = stateMachineCurrentAction.load();
+        return action == StateMachineInternalAction::STATE_EXITING || action == StateMachineInternalAction::TRANSITIONING;
+    }
 
-    void unlockStateMachine(std::string msg);
+    // current state scoped events posted during the transitions (ros params ~deferred_events_capacity and
+    // ~deferred_events_policy: discard (default) or deliver)
+    std::unique_ptr<DeferredEventQueue> deferredEvents_;
 
-    template <typename EventType>
-    void propagateEventToStateReactors(ISmaccState *st, EventType *ev);
+    // delivers or discards the deferred events once the new state is steady
+    void flushDeferredEvents();
+
+    // update phase: see updateMutex_
+    void lockStateMachine(LockSite &site);
+
+    void unlockStateMachine();
+
+    // rebuilds the dispatch table with the state reactors of the current state and its ancestors (or clears it if
+    // there is no current state). Called from the state machine thread when the state reactors may have changed.
+    void refreshStateReactorDispatchTable();
+
+    // accessed through std::atomic_load/std::atomic_store, events are posted from any thread
+    std::shared_ptr<const StateReactorDispatchTable> stateReactorDispatchTable_;
 
     std::shared_ptr<SmaccStateMachineInfo> stateMachineInfo_;
 
@@ -66,5 +66,18 @@ public:
         ROS_INFO("[SmaccStateMachine] Initializing state machine");
         sc::state_machine<DerivedStateMachine, InitialStateType, SmaccAllocator>::initiate();
     }
+
+    // the fifo scheduler calls this from the state machine thread for each queued event
+    virtual void process_event_impl(const sc::event_base &evt) override
+    {
+        if (evt.dynamic_type() == EvStateMachineTask::static_type())
+        {
+            this->runStateMachineTask(static_cast<const EvStateMachineTask &>(evt));
+            return;
+        }
+
+        this->notifyStateReactors(evt);
+        sc::state_machine<DerivedStateMachine, InitialStateType, SmaccAllocator>::process_event(evt);
+    }
 };
 } // namespace smacc
@@ -13,6 +13,7 @@
 #include <smacc/introspection/introspection.h>
 #include <boost/statechart/event.hpp>
 #include <map>
+#include <unordered_map>
 
 namespace smacc
 {
@@ -29,10 +30,16 @@ struct EmptyObjectTag
 class StateReactor
 {
 public:
+    // statechart event type identifier (ie: ev.dynamic_type() or TEvent::static_type()). The default rtti policy of
+    // statechart is assumed (the identifier is a pointer)
+    typedef boost::statechart::event_base::id_type EventTypeId;
+
     ISmaccState *ownerState;
     std::function<void()> postEventFn;
     std::vector<const std::type_info *> eventTypes;
-    std::map<const std::type_info *, std::function<void(void *)>> eventCallbacks_;
+
+    // type based event callbacks
+    std::unordered_map<EventTypeId, std::function<void(const boost::statechart::event_base &)>> eventCallbacks_;
 
     StateReactor();
 
@@ -71,25 +78,41 @@ public:
     //TDerived
     void initialize(ISmaccState *ownerState);
 
+    // input events (same order as eventTypes)
+    inline const std::vector<EventTypeId> &getInputEventIds() const { return eventTypeIds_; }
+
 private:
     friend ISmaccStateMachine;
 
-    template <typename TEvent>
-    void notifyEvent(TEvent *ev)
+    std::vector<EventTypeId> eventTypeIds_;
+
+    // The state machine uses this method to notify this state reactor some of its input events happened. It is called
+    // from the state machine thread before the event is processed, only for the input events of the state reactor
+    // (see StateReactorDispatchTable)
+    void notifyEvent(const boost::statechart::event_base &ev);
+};
+
+// State reactors of the current state and its ancestors indexed by the type of their input events, so that an event
+// reaches the interested state reactors directly (and an event without state reactors only costs a hash lookup).
+// The state machine rebuilds it when a state is entered.
+class StateReactorDispatchTable
+{
+public:
+    // state reactors are notified in the same order they are added
+    void addStateReactor(const std::shared_ptr<StateReactor> &sr);
+
+    // null if there are no state reactors for that event
+    inline const std::vector<std::shared_ptr<StateReactor>> *find(StateReactor::EventTypeId eventType) const
     {
-        //the state machine uses this method to notify this state reactor some event happened.
-        auto tid = &(typeid(TEvent));
-        if (std::find(eventTypes.begin(), eventTypes.end(), tid) != eventTypes.end())
-        {
-            this->onEventNotified(tid);
-            this->update();
-
-            if (eventCallbacks_.count(tid))
-            {
-                eventCallbacks_[tid]((void *)ev);
-            }
-        }
+        auto it = reactors_.find(eventType);
+        if (it == reactors_.end())
+            return nullptr;
+
+        return &it->second;
     }
+
+private:
+    std::unordered_map<StateReactor::EventTypeId, std::vector<std::shared_ptr<StateReactor>>> reactors_;
 };
 
 } // namespace smacc
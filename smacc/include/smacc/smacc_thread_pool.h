@@ -0,0 +1,91 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace smacc
+{
+// Small work-stealing thread pool. Each worker has its own task queue: tasks posted from a worker thread go to its
+// own queue (LIFO, cache friendly), tasks posted from other threads are distributed round robin. Idle workers steal
+// the oldest tasks of the other queues before going to sleep.
+class SmaccThreadPool
+{
+public:
+    // threadCount == 0 means std::thread::hardware_concurrency()
+    explicit SmaccThreadPool(std::size_t threadCount = 0);
+
+    // pending tasks are executed before the workers are joined
+    ~SmaccThreadPool();
+
+    SmaccThreadPool(const SmaccThreadPool &) = delete;
+    SmaccThreadPool &operator=(const SmaccThreadPool &) = delete;
+
+    void post(std::function<void()> task);
+
+    template <typename TFunction>
+    auto submit(TFunction function) -> std::future<decltype(function())>;
+
+    std::size_t getThreadCount() const;
+
+    // tasks that are queued or being executed
+    std::size_t getPendingTaskCount() const;
+
+    unsigned long getStealCount() const;
+
+    // true if the calling thread is one of the workers of this pool
+    bool isWorkerThread() const;
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void workerLoop(std::size_t index);
+
+    bool tryGetTask(std::size_t index, std::function<void()> &task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+
+    std::vector<std::thread> workers_;
+
+    std::mutex waitMutex_;
+
+    std::condition_variable taskAvailable_;
+
+    std::atomic<std::size_t> queuedTasks_;
+
+    std::atomic<std::size_t> pendingTasks_;
+
+    std::atomic<std::size_t> nextQueue_;
+
+    std::atomic<unsigned long> stealCount_;
+
+    bool stopping_;
+};
+
+template <typename TFunction>
+auto SmaccThreadPool::submit(TFunction function) -> std::future<decltype(function())>
+{
+    typedef decltype(function()) TResult;
+
+    // std::function requires copyable callables
+    auto task = std::make_shared<std::packaged_task<TResult()>>(std::move(function));
+    auto future = task->get_future();
+    this->post([task]() { (*task)(); });
+    return future;
+}
+} // namespace smacc
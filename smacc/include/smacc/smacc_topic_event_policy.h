@@ -0,0 +1,216 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#pragma once
+
+#include <ros/ros.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace smacc
+{
+// How the messages of a subscriber (SmaccSubscriberClient, CpTopicSubscriber) are turned into EvTopicMessage events.
+// The signals (onMessageReceived) are always called for every message.
+enum class TopicEventPolicy
+{
+    // one event for each message (default)
+    ALL,
+    // at most one event pending in the state machine queue, the messages received meanwhile are replaced by the
+    // latest one, which is posted when the pending event is released
+    CONFLATE,
+    // at most one event each 1/rate seconds, the other messages do not produce events (the rate must be positive)
+    DECIMATE,
+    // no events, only the signals
+    SIGNAL_ONLY
+};
+
+struct TopicEventStatistics
+{
+    unsigned long received;
+    unsigned long posted;
+
+    // replaced by a newer message while an event was pending (conflate)
+    unsigned long conflated;
+
+    // dropped by the rate limit (decimate)
+    unsigned long decimated;
+
+    // not posted (signal only)
+    unsigned long signalOnly;
+};
+
+// Applies a TopicEventPolicy to the messages of a subscriber. The post function creates and posts the event; it
+// receives a token that the event must keep (EvTopicMessage::conflationToken): the conflate policy knows that the
+// pending event was processed (or discarded) when the token is released.
+template <typename TMessageConstPtr>
+class TopicEventBridge
+{
+public:
+    typedef std::function<void(const TMessageConstPtr &msg, std::shared_ptr<void> token)> PostFunction;
+
+    TopicEventBridge() : state_(std::make_shared<State>()) {}
+
+    ~TopicEventBridge()
+    {
+        // the events may outlive the subscriber
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->post = nullptr;
+    }
+
+    TopicEventBridge(const TopicEventBridge &) = delete;
+    TopicEventBridge &operator=(const TopicEventBridge &) = delete;
+
+    // rateHz is only used by the decimate policy. Returns false (and the policy is not changed) if the decimate
+    // rate is not positive.
+    bool setPolicy(TopicEventPolicy policy, double rateHz = 0)
+    {
+        if (policy == TopicEventPolicy::DECIMATE && !(rateHz > 0))
+        {
+            ROS_ERROR("Incorrect topic event decimate rate: %lf Hz (it must be positive), the event policy is not changed",
+                      rateHz);
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->policy = policy;
+        state_->minPeriod = ros::Duration(policy == TopicEventPolicy::DECIMATE ? 1.0 / rateHz : 0.0);
+        return true;
+    }
+
+    TopicEventPolicy getPolicy() const
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return state_->policy;
+    }
+
+    void setPostFunction(PostFunction post)
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->post = std::move(post);
+    }
+
+    // called for each message received (subscriber callback thread)
+    void onMessage(const TMessageConstPtr &msg)
+    {
+        PostFunction post;
+        std::shared_ptr<void> token;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            auto &statistics = state_->statistics;
+            statistics.received++;
+
+            if (!state_->post)
+                return;
+
+            switch (state_->policy)
+            {
+            case TopicEventPolicy::SIGNAL_ONLY:
+                statistics.signalOnly++;
+                return;
+
+            case TopicEventPolicy::DECIMATE:
+            {
+                auto now = ros::Time::now();
+                if (state_->postedOnce && now - state_->lastPost < state_->minPeriod)
+                {
+                    statistics.decimated++;
+                    return;
+                }
+
+                state_->postedOnce = true;
+                state_->lastPost = now;
+                break;
+            }
+
+            case TopicEventPolicy::CONFLATE:
+                if (state_->pending)
+                {
+                    if (state_->latest)
+                        statistics.conflated++;
+
+                    state_->latest = msg;
+                    return;
+                }
+
+                state_->pending = true;
+                token = State::createToken(state_);
+                break;
+
+            case TopicEventPolicy::ALL:
+                break;
+            }
+
+            statistics.posted++;
+            post = state_->post;
+        }
+
+        // without the lock: a discarded event releases its token (and may post the next one) inside this call
+        post(msg, std::move(token));
+    }
+
+    TopicEventStatistics getStatistics() const
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return state_->statistics;
+    }
+
+private:
+    struct State
+    {
+        State() : policy(TopicEventPolicy::ALL), statistics(), postedOnce(false), pending(false) {}
+
+        mutable std::mutex mutex;
+
+        TopicEventPolicy policy;
+        ros::Duration minPeriod;
+
+        PostFunction post;
+
+        TopicEventStatistics statistics;
+
+        // decimate
+        bool postedOnce;
+        ros::Time lastPost;
+
+        // conflate: an event is pending and the latest message received meanwhile
+        bool pending;
+        TMessageConstPtr latest;
+
+        static std::shared_ptr<void> createToken(const std::shared_ptr<State> &state)
+        {
+            return std::shared_ptr<void>(state.get(), [state](void *) { State::onTokenReleased(state); });
+        }
+
+        // the pending event was processed or discarded, the latest message (if any) is posted
+        static void onTokenReleased(const std::shared_ptr<State> &state)
+        {
+            PostFunction post;
+            TMessageConstPtr msg;
+            std::shared_ptr<void> token;
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->latest || !state->post || state->policy != TopicEventPolicy::CONFLATE)
+                {
+                    state->pending = false;
+                    state->latest = TMessageConstPtr();
+                    return;
+                }
+
+                msg = std::move(state->latest);
+                state->latest = TMessageConstPtr();
+                state->statistics.posted++;
+                post = state->post;
+                token = createToken(state);
+            }
+
+            post(msg, std::move(token));
+        }
+    };
+
+    std::shared_ptr<State> state_;
+};
+} // namespace smacc
@@ -0,0 +1,45 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#pragma once
+
+#include <ros/console.h>
+
+// Traces of the state machine internals done on each transition: creation, entry and exit of the states, and the
+// lifecycle of orthogonals, client behaviors, state reactors and event generators.
+//
+// They are logged through the "smacc_trace" named logger (ros.<package>.smacc_trace) so they can be filtered at
+// runtime from the rosconsole config. As with any rosconsole macro, when the level is disabled the arguments
+// (demangled type names, getName() calls, etc) are not evaluated. Building with SMACC_TRACING=0 (cmake option
+// SMACC_TRACING=OFF) removes them completely.
+#ifndef SMACC_TRACING
+#define SMACC_TRACING 1
+#endif
+
+#define SMACC_TRACE_LOGGER "smacc_trace"
+
+#if SMACC_TRACING
+#define SMACC_TRACE_DEBUG(...) ROS_DEBUG_NAMED(SMACC_TRACE_LOGGER, __VA_ARGS__)
+#define SMACC_TRACE_INFO(...) ROS_INFO_NAMED(SMACC_TRACE_LOGGER, __VA_ARGS__)
+#define SMACC_TRACE_DEBUG_STREAM(args) ROS_DEBUG_STREAM_NAMED(SMACC_TRACE_LOGGER, args)
+#define SMACC_TRACE_INFO_STREAM(args) ROS_INFO_STREAM_NAMED(SMACC_TRACE_LOGGER, args)
+#else
+#define SMACC_TRACE_DEBUG(...) \
+    do                         \
+    {                          \
+    } while (false)
+#define SMACC_TRACE_INFO(...) \
+    do                        \
+    {                         \
+    } while (false)
+#define SMACC_TRACE_DEBUG_STREAM(args) \
+    do                                 \
+    {                                  \
+    } while (false)
+#define SMACC_TRACE_INFO_STREAM(args) \
+    do                                \
+    {                                 \
+    } while (false)
+#endif
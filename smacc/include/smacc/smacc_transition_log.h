@@ -0,0 +1,69 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#pragma once
+
+#include <smacc_msgs/SmaccTransitionLogEntry.h>
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace smacc
+{
+// Fixed capacity log of the last transitions of the state machine. Each entry gets a sequence number (0, 1, 2...)
+// and it is stored in the slot sequence % capacity as an immutable shared record, so the state machine thread
+// (the only writer) never waits for the readers (the history service) and readers never see a half written entry.
+//
+// Optionally, the entries evicted from the ring are appended to a binary file: for each entry, the sequence number
+// (uint64), the size of the message (uint32) and the ros serialization of the SmaccTransitionLogEntry message.
+class TransitionLog
+{
+public:
+    explicit TransitionLog(std::size_t capacity, std::string spillFilePath = "");
+
+    ~TransitionLog();
+
+    TransitionLog(const TransitionLog &) = delete;
+    TransitionLog &operator=(const TransitionLog &) = delete;
+
+    // only called from the state machine thread, returns the sequence number of the entry
+    uint64_t append(const smacc_msgs::SmaccTransitionLogEntry &entry);
+
+    // Copies up to maxEntries (0 means all) entries with sequence number >= fromSequence that are still in the ring.
+    // Returns the sequence number of the first copied entry (older entries may have been evicted). The sequence of
+    // the entry that follows the last copied one is stored in nextSequence (the fromSequence of the next request).
+    uint64_t read(uint64_t fromSequence, std::size_t maxEntries, std::vector<smacc_msgs::SmaccTransitionLogEntry> &entries,
+                  uint64_t &nextSequence) const;
+
+    // sequence number of the next appended entry (ie: the number of entries appended since the creation)
+    uint64_t getNextSequence() const;
+
+    // sequence number of the oldest entry kept in the ring
+    uint64_t getOldestSequence() const;
+
+    std::size_t getCapacity() const;
+
+private:
+    struct Record
+    {
+        uint64_t sequence;
+        smacc_msgs::SmaccTransitionLogEntry entry;
+    };
+
+    void spill(const Record &record);
+
+    std::vector<std::shared_ptr<const Record>> slots_;
+
+    std::atomic<uint64_t> nextSequence_;
+
+    std::ofstream spillFile_;
+
+    std::vector<uint8_t> spillBuffer_;
+};
+} // namespace smacc
@@ -0,0 +1,98 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace smacc
+{
+namespace type_index_detail
+{
+// returns the next free index of the family, defined in smacc_type_index.cpp
+std::size_t allocateTypeIndex(const std::type_info &family);
+
+// number of indexes allocated in the family
+std::size_t getTypeIndexCount(const std::type_info &family);
+} // namespace type_index_detail
+
+// Dense per-type identifier (0, 1, 2...) inside a family of types (ie: orthogonals, components, clients). It is
+// assigned the first time it is requested and then it is a plain static read, so it can be used to index arrays.
+template <typename TFamily, typename T>
+std::size_t getTypeIndex()
+{
+    static const std::size_t index = type_index_detail::allocateTypeIndex(typeid(TFamily));
+    return index;
+}
+
+template <typename TFamily>
+std::size_t getTypeIndexCount()
+{
+    return type_index_detail::getTypeIndexCount(typeid(TFamily));
+}
+
+// Objects indexed by their exact type (the one used to register them) and an optional name. A lookup is an array
+// access plus a name hash comparison for each object of the same type (usually one).
+template <typename TFamily>
+class TypeIndexedRegistry
+{
+public:
+    // position of an object among the ones of the same type and name: find returns the one with the lowest order, and
+    // the first added one for the same order
+    typedef std::pair<std::string, std::size_t> Order;
+
+    template <typename T>
+    void add(T *object, const std::string &name = std::string(), const Order &order = Order())
+    {
+        auto index = getTypeIndex<TFamily, T>();
+        if (entries_.size() <= index)
+            entries_.resize(index + 1);
+
+        auto &candidates = entries_[index];
+        auto position = std::upper_bound(candidates.begin(), candidates.end(), order,
+                                         [](const Order &order, const Entry &entry) { return order < entry.order; });
+
+        candidates.insert(position, Entry{std::hash<std::string>()(name), name, order, object});
+    }
+
+    template <typename T>
+    T *find(const std::string &name = std::string()) const
+    {
+        auto index = getTypeIndex<TFamily, T>();
+        if (index >= entries_.size())
+            return nullptr;
+
+        auto &candidates = entries_[index];
+        if (candidates.empty())
+            return nullptr;
+
+        auto nameHash = std::hash<std::string>()(name);
+        for (auto &entry : candidates)
+        {
+            if (entry.nameHash == nameHash && entry.name == name)
+                return static_cast<T *>(entry.object);
+        }
+
+        return nullptr;
+    }
+
+private:
+    struct Entry
+    {
+        std::size_t nameHash;
+        std::string name;
+        Order order;
+        void *object;
+    };
+
+    std::vector<std::vector<Entry>> entries_;
+};
+} // namespace smacc
@@ -5,13 +5,28 @@
  ******************************************************************************************************************/
 
 #pragma once
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <boost/optional.hpp>
 #include <ros/duration.h>
 #include <ros/time.h>
 
 namespace smacc
 {
+struct UpdateStatistics
+{
+    unsigned long updateCount;
+    // updates that lasted more than the update period
+    unsigned long overrunCount;
+    // updates that were due but skipped because the previous one was still running in the thread pool
+    unsigned long skippedCount;
+    double lastDuration;
+    double maxDuration;
+    double meanDuration;
+};
+
 class ISmaccUpdatable
 {
 public:
@@ -20,12 +35,89 @@ public:
 
     void executeUpdate();
     void setUpdatePeriod(ros::Duration duration);
+    void setUpdateRate(double hz);
+
+    // Thread safe updatables are updated by the signal detector thread pool, without locking the state machine.
+    // Otherwise they are updated in the signal detector thread with the state machine locked (default).
+    void setUpdateThreadSafe(bool threadSafe);
+    bool isUpdateThreadSafe() const;
+
+    UpdateStatistics getUpdateStatistics() const;
+
+    // Requests an update call at the specified time (or as soon as possible). It can be called from any thread and
+    // it wakes up the signal detector when it is running in event driven mode.
+    void scheduleUpdate(ros::Time deadline);
+    void requestUpdate();
+
+    // On demand updatables are only updated when some scheduled deadline expires. Otherwise, updatables without
+    // update period are updated in every signal detector loop.
+    void setUpdateOnDemand(bool onDemand);
+    bool isUpdateOnDemand() const;
+
+    // Earliest time this object needs to be updated (update period or scheduled deadline). If it does not
+    // have any, the update rate is decided by the signal detector.
+    boost::optional<ros::Time> getNextUpdateDeadline() const;
 
 protected:
     virtual void update() = 0;
 
 private:
+    // returns true (and consumes the deadline) if the update has to be executed now
+    bool checkUpdateDue(const ros::Time &now);
+
+    // calls update() and collects the statistics
+    void runUpdate();
+
+    // used by the signal detector to dispatch the update to the thread pool only once at a time
+    bool tryBeginAsyncUpdate();
+    void endAsyncUpdate();
+    void countSkippedUpdate();
+
+    // no more updates are dispatched and waits the current one (if any) to finish. Used when the object is disposed,
+    // it must not be called with locks that the update may need.
+    void retireUpdates();
+
     boost::optional<ros::Duration> periodDuration_;
     ros::Time lastUpdate_;
+
+    // nanoseconds of the scheduled deadline, 0 if it is not scheduled
+    std::atomic<uint64_t> scheduledDeadline_;
+
+    bool onDemand_;
+
+    std::atomic<bool> threadSafe_;
+
+    std::atomic<bool> updateInProgress_;
+
+    std::atomic<bool> retired_;
+
+    // signalled by endAsyncUpdate (retireUpdates waits on it)
+    std::mutex updateFinishedMutex_;
+    std::condition_variable updateFinished_;
+
+    mutable std::mutex statisticsMutex_;
+    UpdateStatistics statistics_;
+
+    friend class SignalDetector;
 };
-} // namespace smacc
\ No newline at end of file
+
+// wakes up the signal detector if it is waiting for the next update deadline
+void wakeUpSignalDetector();
+
+// called by the signal detectors when their event driven loop starts (true) and finishes (false)
+void setSignalDetectorEventDriven(bool eventDriven);
+
+// true if any signal detector is waiting for the update deadlines (the others poll at a fixed rate)
+bool isSignalDetectorEventDriven();
+
+// compile time conversion used to register the updatable elements when they are created (no rtti is needed)
+inline ISmaccUpdatable *asUpdatable(ISmaccUpdatable *object)
+{
+    return object;
+}
+
+inline ISmaccUpdatable *asUpdatable(void *)
+{
+    return nullptr;
+}
+} // namespace smacc
@@ -33,7 +33,7 @@ void ISmaccClient::getComponents(std::vector<std::shared_ptr<ISmaccComponent>> &
 
 std::string ISmaccClient::getName() const
 {
-    std::string keyname = demangleSymbol(typeid(*this).name());
+    std::string keyname = demangleType(typeid(*this));
     return keyname;
 }
 
@@ -6,16 +6,42 @@
 #include "smacc/common.h"
 #include "smacc/client_bases/smacc_action_client_base.h"
 
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+
 namespace smacc
 {
 namespace utils
 {
     
-std::string cleanShortTypeName(const std::type_info &tinfo)
+namespace
 {
-    auto typeinfo= TypeInfo::getFromStdTypeInfo(tinfo);
-    auto nontemplatedfullclasname = typeinfo->getNonTemplatedTypeName();
+std::mutex shortTypeNamesMutex;
 
+std::unordered_map<std::type_index, std::string> &getShortTypeNames()
+{
+    // intentionally leaked, see demangleType
+    static auto *shortTypeNames = new std::unordered_map<std::type_index, std::string>();
+    return *shortTypeNames;
+}
+} // namespace
+
+const std::string &cleanShortTypeName(const std::type_info &tinfo)
+{
+    std::type_index key(tinfo);
+    auto &shortTypeNames = getShortTypeNames();
+    {
+        std::lock_guard<std::mutex> lock(shortTypeNamesMutex);
+        auto it = shortTypeNames.find(key);
+        if (it != shortTypeNames.end())
+            return it->second;
+    }
+
+    // the type info database is not thread safe
+    std::lock_guard<std::mutex> lock(shortTypeNamesMutex);
+    auto typeinfo = TypeInfo::getFromStdTypeInfo(tinfo);
+    auto nontemplatedfullclasname = typeinfo->getNonTemplatedTypeName();
 
     //ROS_INFO("State full classname: %s", fullclassname.c_str());
 
@@ -24,8 +50,7 @@ std::string cleanShortTypeName(const std::type_info &tinfo)
     std::string classname = strs.back();
     //ROS_INFO("State classname: %s", classname.c_str());
 
-    
-    return classname;
+    return shortTypeNames.emplace(key, classname).first->second;
 }
 } // namespace utils
 } // namespace smacc
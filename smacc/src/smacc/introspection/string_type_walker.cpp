@@ -63,7 +63,7 @@ std::map<std::string, TypeInfo::Ptr> TypeInfo::typeInfoDatabase;
 
 TypeInfo::Ptr TypeInfo::getFromStdTypeInfo(const std::type_info& tid)
 {
-  return TypeInfo::getTypeInfoFromString(demangleSymbol(tid.name()));
+  return TypeInfo::getTypeInfoFromString(demangleType(tid));
 }
 
 TypeInfo::Ptr TypeInfo::getTypeInfoFromString(std::string inputtext)
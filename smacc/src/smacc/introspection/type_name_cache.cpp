@@ -0,0 +1,47 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#include <smacc/introspection/introspection.h>
+
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+
+namespace smacc
+{
+namespace introspection
+{
+namespace
+{
+std::mutex typeNamesMutex;
+
+// the references to the elements of an unordered_map are not invalidated by the insertions
+std::unordered_map<std::type_index, std::string> &getTypeNames()
+{
+    // intentionally leaked: names are also requested during the static destruction (ie: logs of destructors)
+    static auto *typeNames = new std::unordered_map<std::type_index, std::string>();
+    return *typeNames;
+}
+} // namespace
+
+const std::string &demangleType(const std::type_info &tinfo)
+{
+    std::type_index key(tinfo);
+    auto &typeNames = getTypeNames();
+    {
+        std::lock_guard<std::mutex> lock(typeNamesMutex);
+        auto it = typeNames.find(key);
+        if (it != typeNames.end())
+            return it->second;
+    }
+
+    // demangled out of the lock, if other thread inserts the same type meanwhile its name is kept
+    auto demangled = demangleSymbol(tinfo.name());
+
+    std::lock_guard<std::mutex> lock(typeNamesMutex);
+    return typeNames.emplace(key, std::move(demangled)).first->second;
+}
+} // namespace introspection
+} // namespace smacc
@@ -14,7 +14,7 @@ namespace smacc
     {
         if (clBehavior != nullptr)
         {
-            ROS_INFO("[Orthogonal %s] adding client behavior: %s", this->getName().c_str(), clBehavior->getName().c_str());
+            SMACC_TRACE_INFO("[Orthogonal %s] adding client behavior: %s", this->getName().c_str(), clBehavior->getName().c_str());
             clBehavior->stateMachine_ = this->getStateMachine();
             clBehavior->currentOrthogonal = this;
 
@@ -22,7 +22,7 @@ namespace smacc
         }
         else
         {
-            ROS_INFO("[orthogonal %s] no client behaviors in this state", this->getName().c_str());
+            SMACC_TRACE_INFO("[orthogonal %s] no client behaviors in this state", this->getName().c_str());
         }
     }
 
@@ -32,14 +32,14 @@ namespace smacc
 
     std::string ISmaccOrthogonal::getName() const
     {
-        return demangleSymbol(typeid(*this).name());
+        return demangleType(typeid(*this));
     }
 
     void ISmaccOrthogonal::runtimeConfigure()
     {
         for (auto &clBehavior : clientBehaviors_)
         {
-            ROS_INFO("[Orthogonal %s] runtimeConfigure, current Behavior: %s", this->getName().c_str(),
+            SMACC_TRACE_INFO("[Orthogonal %s] runtimeConfigure, current Behavior: %s", this->getName().c_str(),
                      clBehavior->getName().c_str());
 
             clBehavior->runtimeConfigure();
@@ -52,7 +52,7 @@ namespace smacc
         {
             for (auto &clBehavior : clientBehaviors_)
             {
-                ROS_INFO("[Orthogonal %s] OnEntry, current Behavior: %s", this->getName().c_str(), clBehavior->getName().c_str());
+                SMACC_TRACE_INFO("[Orthogonal %s] OnEntry, current Behavior: %s", this->getName().c_str(), clBehavior->getName().c_str());
 
                 try
                 {
@@ -67,7 +67,7 @@ namespace smacc
         }
         else
         {
-            ROS_INFO("[Orthogonal %s] OnEntry", this->getName().c_str());
+            SMACC_TRACE_INFO("[Orthogonal %s] OnEntry", this->getName().c_str());
         }
     }
 
@@ -77,7 +77,7 @@ namespace smacc
         {
             for (auto &clBehavior : clientBehaviors_)
             {
-                ROS_INFO("[Orthogonal %s] OnExit, current Behavior: %s", this->getName().c_str(), clBehavior->getName().c_str());
+                SMACC_TRACE_INFO("[Orthogonal %s] OnExit, current Behavior: %s", this->getName().c_str(), clBehavior->getName().c_str());
                 try
                 {
                     clBehavior->executeOnExit();
@@ -91,6 +91,7 @@ namespace smacc
             int i = 0;
             for (auto &clBehavior : clientBehaviors_)
             {
+                this->getStateMachine()->unregisterUpdatableStateElement(dynamic_cast<ISmaccUpdatable *>(clBehavior.get()));
                 clBehavior->dispose();
                 clientBehaviors_[i] = nullptr;
             }
@@ -99,7 +100,7 @@ namespace smacc
         }
         else
         {
-            ROS_INFO("[Orthogonal %s] OnExit", this->getName().c_str());
+            SMACC_TRACE_INFO("[Orthogonal %s] OnExit", this->getName().c_str());
         }
     }
 } // namespace smacc
\ No newline at end of file
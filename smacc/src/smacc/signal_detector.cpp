@@ -6,6 +6,8 @@
 #include <smacc/client_bases/smacc_action_client_base.h>
 #include <smacc/smacc_signal_detector.h>
 #include <smacc/smacc_state_machine.h>
+#include <ros/callback_queue.h>
+#include <algorithm>
 #include <thread>
 
 namespace smacc
@@ -15,10 +17,12 @@ namespace smacc
  * SignalDetector()
  ******************************************************************************************************************
  */
-SignalDetector::SignalDetector(SmaccFifoScheduler *scheduler) : end_(false), initialized_(false)
+SignalDetector::SignalDetector(SmaccFifoScheduler *scheduler)
+  : updatableClientsChanged_(false), updatableStateElementsChanged_(false), end_(false), initialized_(false)
 {
   scheduler_ = scheduler;
   loop_rate_hz = 20.0;
+  eventDriven_ = false;
 }
 
 /**
@@ -30,100 +34,110 @@ void SignalDetector::initialize(ISmaccStateMachine *stateMachine)
 {
   smaccStateMachine_ = stateMachine;
   lastState_ = std::numeric_limits<unsigned long>::quiet_NaN();
-  findUpdatableClients();
   initialized_ = true;
 }
 
 /**
  ******************************************************************************************************************
- * findUpdatableClients()
+ * registerUpdatableClient()
  ******************************************************************************************************************
  */
-void SignalDetector::findUpdatableClients()
+void SignalDetector::registerUpdatableClient(ISmaccUpdatable *updatable)
 {
-  this->updatableClients_.clear();
-  for (auto pair : this->smaccStateMachine_->getOrthogonals())
-  {
-    auto &orthogonal = pair.second;
-    auto &clients = orthogonal->getClients();
-
-    for (auto &client : clients)
-    {
-      // updatable client components
-      auto updatableClient = dynamic_cast<ISmaccUpdatable *>(client.get());
+  std::lock_guard<std::mutex> lock(updatablesMutex_);
+  ROS_DEBUG_STREAM("Adding updatable client/component: " << demangleType(typeid(*updatable)));
+  registeredClients_.push_back(updatable);
+  updatableClientsChanged_ = true;
+}
 
-      if (updatableClient != nullptr)
-      {
-        ROS_DEBUG_STREAM("Adding updatable client: " << demangleType(typeid(updatableClient)));
-        this->updatableClients_.push_back(updatableClient);
-      }
+/**
+ ******************************************************************************************************************
+ * registerUpdatableStateElement()
+ ******************************************************************************************************************
+ */
+void SignalDetector::registerUpdatableStateElement(ISmaccUpdatable *updatable, ISmaccState *ownerState)
+{
+  std::lock_guard<std::mutex> lock(updatablesMutex_);
+  ROS_DEBUG_STREAM("Adding updatable state element: " << demangleType(typeid(*updatable)));
+  registeredStateElements_.push_back(std::make_pair(updatable, ownerState));
+  updatableStateElementsChanged_ = true;
+}
 
-      // updatable client components
-      std::vector<std::shared_ptr<ISmaccComponent>> components;
-      client->getComponents(components);
-      for (auto &componententry : components)
-      {
-        auto updatableComponent = dynamic_cast<ISmaccUpdatable *>(componententry.get());
-        if (updatableComponent != nullptr)
-        {
-          ROS_DEBUG_STREAM("Adding updatable component: " << demangleType(typeid(*updatableComponent)));
-          this->updatableClients_.push_back(updatableComponent);
-        }
-      }
-    }
+/**
+ ******************************************************************************************************************
+ * unregisterUpdatableStateElement()
+ ******************************************************************************************************************
+ */
+void SignalDetector::unregisterUpdatableStateElement(ISmaccUpdatable *updatable)
+{
+  {
+    std::lock_guard<std::mutex> lock(updatablesMutex_);
+    auto it = std::remove_if(registeredStateElements_.begin(), registeredStateElements_.end(),
+                             [&](const std::pair<ISmaccUpdatable *, ISmaccState *> &entry) { return entry.first == updatable; });
+    registeredStateElements_.erase(it, registeredStateElements_.end());
+    updatableStateElementsChanged_ = true;
   }
+
+  // it may be running in the thread pool (waited without the lock, the polling loop keeps working meanwhile)
+  updatable->retireUpdates();
 }
 
 /**
  ******************************************************************************************************************
- * findUpdatableClientBehaviors()
+ * unregisterUpdatableStateElements()
  ******************************************************************************************************************
  */
-void SignalDetector::findUpdatableStateElements(ISmaccState *currentState)
+void SignalDetector::unregisterUpdatableStateElements(ISmaccState *ownerState)
 {
-  this->updatableStateElements_.clear();
-  for (auto pair : this->smaccStateMachine_->getOrthogonals())
+  std::vector<ISmaccUpdatable *> removed;
   {
-    auto &orthogonal = pair.second;
-    auto &behaviors = orthogonal->getClientBehaviors();
+    std::lock_guard<std::mutex> lock(updatablesMutex_);
+    auto it = std::partition(registeredStateElements_.begin(), registeredStateElements_.end(),
+                             [&](const std::pair<ISmaccUpdatable *, ISmaccState *> &entry) { return entry.second != ownerState; });
 
-    for (auto &currentBehavior : behaviors)
+    for (auto entry = it; entry != registeredStateElements_.end(); entry++)
     {
-      ISmaccUpdatable *updatableClientBehavior = dynamic_cast<ISmaccUpdatable *>(currentBehavior.get());
-
-      if (updatableClientBehavior != nullptr)
-      {
-        ROS_DEBUG_STREAM("Adding updatable behavior: " << demangleType(typeid(updatableClientBehavior)));
-        this->updatableStateElements_.push_back(updatableClientBehavior);
-      }
+      removed.push_back(entry->first);
     }
-  }
 
-  auto updatableState = dynamic_cast<ISmaccUpdatable *>(currentState);
-  if (updatableState != nullptr)
-  {
-    this->updatableStateElements_.push_back(updatableState);
+    registeredStateElements_.erase(it, registeredStateElements_.end());
+    updatableStateElementsChanged_ = true;
   }
 
-  auto statereactors = currentState->getStateReactors();
-  for (auto &sr : statereactors)
+  // they may be running in the thread pool (waited without the lock, the polling loop keeps working meanwhile)
+  for (auto updatable : removed)
   {
-    ISmaccUpdatable *updatableStateReactor = dynamic_cast<ISmaccUpdatable *>(sr.get());
-    if (updatableStateReactor != nullptr)
-    {
-      ROS_DEBUG_STREAM("Adding updatable stateReactorr: " << demangleType(typeid(updatableStateReactor)));
-      this->updatableStateElements_.push_back(updatableStateReactor);
-    }
+    updatable->retireUpdates();
   }
+}
 
-  auto eventgenerators = currentState->getEventGenerators();
-  for (auto &eg : eventgenerators)
+/**
+ ******************************************************************************************************************
+ * refreshUpdatableClients()
+ ******************************************************************************************************************
+ */
+void SignalDetector::refreshUpdatableClients()
+{
+  std::lock_guard<std::mutex> lock(updatablesMutex_);
+  updatableClientsChanged_ = false;
+  this->updatableClients_.assign(registeredClients_.begin(), registeredClients_.end());
+}
+
+/**
+ ******************************************************************************************************************
+ * refreshUpdatableStateElements()
+ ******************************************************************************************************************
+ */
+void SignalDetector::refreshUpdatableStateElements(ISmaccState *currentState)
+{
+  std::lock_guard<std::mutex> lock(updatablesMutex_);
+  updatableStateElementsChanged_ = false;
+  this->updatableStateElements_.clear();
+  for (auto &entry : registeredStateElements_)
   {
-    ISmaccUpdatable *updatableEventGenerator = dynamic_cast<ISmaccUpdatable *>(eg.get());
-    if (updatableEventGenerator != nullptr)
+    if (entry.second == nullptr || entry.second == currentState)
     {
-      ROS_DEBUG_STREAM("Adding updatable eventGenerator: " << demangleType(typeid(updatableEventGenerator)));
-      this->updatableStateElements_.push_back(updatableEventGenerator);
+      this->updatableStateElements_.push_back(entry.first);
     }
   }
 }
@@ -166,6 +180,100 @@ void SignalDetector::join()
 void SignalDetector::stop()
 {
   end_ = true;
+  this->wakeUp();
+}
+
+/**
+ ******************************************************************************************************************
+ * wakeUp()
+ ******************************************************************************************************************
+ */
+void SignalDetector::wakeUp()
+{
+  if (eventDriven_)
+  {
+    wakeUpSignalDetector();
+  }
+}
+
+/**
+ ******************************************************************************************************************
+ * dispatchUpdate()
+ ******************************************************************************************************************
+ */
+void SignalDetector::dispatchUpdate(ISmaccUpdatable *updatable, const ros::Time &now)
+{
+  if (threadPool_ == nullptr || !updatable->isUpdateThreadSafe())
+  {
+    updatable->executeUpdate();
+    return;
+  }
+
+  if (!updatable->checkUpdateDue(now))
+  {
+    return;
+  }
+
+  if (!updatable->tryBeginAsyncUpdate())
+  {
+    // the previous update is still running (or the object is being disposed)
+    updatable->countSkippedUpdate();
+    return;
+  }
+
+  threadPool_->post([updatable]() {
+    try
+    {
+      updatable->runUpdate();
+    }
+    catch (std::exception &ex)
+    {
+      ROS_ERROR("Exception during thread pool update. %s", ex.what());
+    }
+
+    updatable->endAsyncUpdate();
+  });
+}
+
+/**
+ ******************************************************************************************************************
+ * updateElement()
+ ******************************************************************************************************************
+ */
+void SignalDetector::updateElement(ISmaccUpdatable *updatable, const ros::Time &now, bool loopTick)
+{
+  if (!eventDriven_)
+  {
+    this->dispatchUpdate(updatable, now);
+    return;
+  }
+
+  auto deadline = updatable->getNextUpdateDeadline();
+  if (deadline)
+  {
+    if (*deadline <= now)
+    {
+      this->dispatchUpdate(updatable, now);
+      deadline = updatable->getNextUpdateDeadline();
+    }
+
+    if (deadline && *deadline < nextDeadline_)
+    {
+      nextDeadline_ = *deadline;
+    }
+  }
+  else if (!updatable->isUpdateOnDemand())
+  {
+    if (loopTick)
+    {
+      this->dispatchUpdate(updatable, now);
+    }
+
+    if (nextLoopTick_ < nextDeadline_)
+    {
+      nextDeadline_ = nextLoopTick_;
+    }
+  }
 }
 
 /**
@@ -179,9 +287,27 @@ void SignalDetector::pollOnce()
 
   try
   {
-    smaccStateMachine_->lockStateMachine("update behaviors");
+    smaccStateMachine_->lockStateMachine(SMACC_LOCK_SITE("SignalDetector::pollOnce"));
 
-    this->findUpdatableClients();
+    auto now = ros::Time::now();
+    bool loopTick = true;
+    if (eventDriven_)
+    {
+      // the updatables without deadline are updated at the loop rate
+      loopTick = now >= nextLoopTick_;
+      if (loopTick)
+      {
+        nextLoopTick_ = now + ros::Duration(1.0 / loop_rate_hz);
+      }
+
+      // upper bound of the sleep time, it is reduced by the updatable elements deadlines
+      nextDeadline_ = now + ros::Duration(1.0);
+    }
+
+    if (updatableClientsChanged_)
+    {
+      this->refreshUpdatableClients();
+    }
     ROS_DEBUG_STREAM("updatable clients: " << this->updatableClients_.size());
 
     if (this->updatableClients_.size())
@@ -189,7 +315,7 @@ void SignalDetector::pollOnce()
       for (auto *updatableClient : this->updatableClients_)
       {
         ROS_DEBUG_STREAM("[PollOnce] update client call:  " << demangleType(typeid(updatableClient)));
-        updatableClient->executeUpdate();
+        this->updateElement(updatableClient, now, loopTick);
       }
     }
 
@@ -211,19 +337,19 @@ void SignalDetector::pollOnce()
 
         if (currentStateIndex != 0)
         {
-          if (currentStateIndex != this->lastState_)
+          if (currentStateIndex != this->lastState_ || updatableStateElementsChanged_)
           {
-            ROS_DEBUG_STREAM("[PollOnce] detected new state, refreshing updatable client behavior table");
+            ROS_DEBUG_STREAM("[PollOnce] detected new state or state elements, refreshing updatable state elements table");
             // we are in a new state, refresh the updatable client behaviors table
             this->lastState_ = currentStateIndex;
-            this->findUpdatableStateElements(currentState);
+            this->refreshUpdatableStateElements(currentState);
           }
 
           ROS_DEBUG_STREAM("updatable state elements: " << this->updatableStateElements_.size());
           for (auto *udpatableStateElement : this->updatableStateElements_)
           {
             ROS_DEBUG_STREAM("pollOnce update client behavior call: " << demangleType(typeid(*udpatableStateElement)));
-            udpatableStateElement->executeUpdate();
+            this->updateElement(udpatableStateElement, now, loopTick);
           }
         }
       }
@@ -234,7 +360,7 @@ void SignalDetector::pollOnce()
     ROS_ERROR("Exception during Signal Detector update loop. %s", ex.what());
   }
 
-  smaccStateMachine_->unlockStateMachine("update behaviors");
+  smaccStateMachine_->unlockStateMachine();
 }
 
 /**
@@ -268,15 +394,49 @@ void SignalDetector::pollingLoop()
 
   nh.setParam("signal_detector_loop_freq", this->loop_rate_hz);
 
+  int threadPoolSize = 2;
+  nh.getParam("signal_detector_thread_pool_size", threadPoolSize);
+  nh.setParam("signal_detector_thread_pool_size", threadPoolSize);
+  if (threadPoolSize > 0)
+  {
+    threadPool_.reset(new SmaccThreadPool(threadPoolSize));
+  }
+
+  bool eventDriven = false;
+  nh.getParam("signal_detector_event_driven", eventDriven);
+  nh.setParam("signal_detector_event_driven", eventDriven);
+  this->eventDriven_ = eventDriven;
+
   ROS_INFO_STREAM("[SignalDetector] loop rate hz:" << loop_rate_hz);
 
-  ros::Rate r(loop_rate_hz);
-  while (ros::ok() && !end_)
+  if (eventDriven_)
   {
-    ROS_INFO_STREAM_THROTTLE(10, "[SignalDetector] heartbeat");
-    pollOnce();
-    ros::spinOnce();
-    r.sleep();
+    ROS_INFO("[SignalDetector] event driven mode");
+    auto *callbackQueue = ros::getGlobalCallbackQueue();
+    setSignalDetectorEventDriven(true);
+
+    while (ros::ok() && !end_)
+    {
+      ROS_INFO_STREAM_THROTTLE(10, "[SignalDetector] heartbeat");
+      pollOnce();
+
+      // sleeps until the next deadline, but it is woken up by any ros callback (processed in this thread)
+      double timeout = (nextDeadline_ - ros::Time::now()).toSec();
+      callbackQueue->callAvailable(ros::WallDuration(std::max(timeout, 0.0)));
+    }
+
+    setSignalDetectorEventDriven(false);
+  }
+  else
+  {
+    ros::Rate r(loop_rate_hz);
+    while (ros::ok() && !end_)
+    {
+      ROS_INFO_STREAM_THROTTLE(10, "[SignalDetector] heartbeat");
+      pollOnce();
+      ros::spinOnce();
+      r.sleep();
+    }
   }
 }
 }  // namespace smacc
\ No newline at end of file
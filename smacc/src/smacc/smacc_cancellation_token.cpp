@@ -0,0 +1,35 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#include <smacc/smacc_cancellation_token.h>
+
+namespace smacc
+{
+CancellationToken::CancellationToken()
+    : cancelled_(false)
+{
+}
+
+bool CancellationToken::isCancelled() const
+{
+    return cancelled_.load(std::memory_order_acquire);
+}
+
+bool CancellationToken::waitForCancellation(std::chrono::nanoseconds timeout) const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cancelledCondition_.wait_for(lock, timeout, [this] { return this->isCancelled(); });
+}
+
+void CancellationToken::cancel()
+{
+    {
+        // the flag is modified with the mutex locked so that the notification is not lost
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_.store(true, std::memory_order_release);
+    }
+    cancelledCondition_.notify_all();
+}
+} // namespace smacc
@@ -1,69 +1,112 @@
 #include <smacc/smacc_asynchronous_client_behavior.h>
+#include <smacc/smacc_executor.h>
+#include <smacc/smacc_state_machine.h>
 
 namespace smacc
 {
+    SmaccAsyncClientBehavior::SmaccAsyncClientBehavior()
+        : entryFinished_(true), exitRequested_(false)
+    {
+        exitFuture_ = exitPromise_.get_future();
+    }
+
     void SmaccAsyncClientBehavior::executeOnEntry()
     {
-        ROS_INFO_STREAM("[" << getName() << "] Creating asynchronous onEntry thread");
-        this->onEntryThread_ = std::async(std::launch::async,
-                                          [=] {
-                                              this->onEntry();
-                                              this->postFinishEventFn_();
-                                              return 0;
-                                          });
+        {
+            std::lock_guard<std::mutex> lock(entryMutex_);
+            entryFinished_ = false;
+        }
+
+        // the tasks keep the behavior alive, it may be detached before they finish (see dispose)
+        auto self = this->shared_from_this();
+
+        SMACC_TRACE_INFO_STREAM("[" << getName() << "] Posting asynchronous onEntry");
+        SmaccExecutor::getAsyncBehaviorExecutor().post([this, self] {
+            try
+            {
+                this->onEntry();
+            }
+            catch (const std::exception &e)
+            {
+                ROS_ERROR("[%s] Exception on asynchronous onEntry: %s", this->getName().c_str(), e.what());
+            }
+
+            this->postFinishEventFn_();
+
+            std::lock_guard<std::mutex> lock(entryMutex_);
+            entryFinished_ = true;
+            if (exitRequested_)
+            {
+                // the state was already leaving, continue with the exit
+                this->postExit();
+            }
+        });
     }
 
     void SmaccAsyncClientBehavior::executeOnExit()
     {
-        ROS_INFO_STREAM("[" << getName() << "] onExit - join async onEntry thread");
+        cancellationToken_.cancel();
 
-        try
+        std::lock_guard<std::mutex> lock(entryMutex_);
+        exitRequested_ = true;
+        if (entryFinished_)
         {
-            ros::Rate r(200);
-            while (ros::ok())
-            {
-                bool valid = this->onEntryThread_.valid();
-                if (valid)
-                {
-                    auto status = this->onEntryThread_.wait_for(std::chrono::milliseconds(20));
-                    if (status == std::future_status::ready)
-                    {
-                        this->onEntryThread_.get();
-                        break;
-                    }
-                }
-
-                r.sleep();
-                ros::spinOnce();
-                ROS_DEBUG("waiting for finishing client behavior");
-            }
+            this->postExit();
         }
-        catch (const std::exception &e)
+        else
         {
-            ROS_DEBUG("[SmaccAsyncClientBehavior] trying to Join onEntry function, but it was alredy finished.");
+            SMACC_TRACE_INFO_STREAM("[" << getName() << "] onExit - it will be executed when the asynchronous onEntry finishes");
         }
+    }
+
+    void SmaccAsyncClientBehavior::postExit()
+    {
+        SMACC_TRACE_INFO_STREAM("[" << getName() << "] Posting asynchronous onExit");
+        auto self = this->shared_from_this();
+        SmaccExecutor::getAsyncBehaviorExecutor().post([this, self] {
+            try
+            {
+                this->onExit();
+            }
+            catch (const std::exception &e)
+            {
+                ROS_ERROR("[%s] Exception on asynchronous onExit: %s", this->getName().c_str(), e.what());
+            }
 
-        ROS_INFO_STREAM("[" << getName() << "] onExit - Creating asynchronous onExit thread");
-        this->onExitThread_ = std::async(std::launch::async,
-                                         [=] {
-                                             this->onExit();
-                                             return 0;
-                                         });
+            exitPromise_.set_value();
+        });
     }
 
     void SmaccAsyncClientBehavior::dispose()
     {
-        ROS_DEBUG_STREAM("[" << getName() << "] Destroying client behavior- Waiting finishing of asynchronous onExit thread");
-        try
+        SMACC_TRACE_DEBUG_STREAM("[" << getName() << "] Destroying client behavior- Waiting finishing of asynchronous onExit");
+
+        auto *stateMachine = this->getStateMachine();
+        auto deadline = exitDeadline_ ? *exitDeadline_ : stateMachine->getAsyncBehaviorExitDeadline();
+
+        auto start = std::chrono::steady_clock::now();
+        bool expired = false;
+        if (deadline > ros::Duration(0))
         {
-            this->onExitThread_.get();
+            expired = this->exitFuture_.wait_for(std::chrono::nanoseconds(deadline.toNSec())) == std::future_status::timeout;
         }
-        catch (...)
+        else
         {
-            ROS_DEBUG("[SmaccAsyncClientBehavior] trying to Join onExit function, but it was alredy finished.");
+            this->exitFuture_.wait();
         }
 
-        ROS_DEBUG_STREAM("[" << getName() << "] Destroying client behavior-  onExit thread finished. Proccedding destruction.");
+        std::chrono::duration<double> delay = std::chrono::steady_clock::now() - start;
+        stateMachine->addAsyncBehaviorExitDelay(this->getName(), delay.count(), expired);
+
+        if (expired)
+        {
+            ROS_WARN("[%s] asynchronous behavior still running after the exit deadline (%.3f s), detaching it",
+                     this->getName().c_str(), deadline.toSec());
+        }
+        else
+        {
+            SMACC_TRACE_DEBUG_STREAM("[" << getName() << "] Destroying client behavior-  onExit finished. Proccedding destruction.");
+        }
     }
 
     SmaccAsyncClientBehavior::~SmaccAsyncClientBehavior()
@@ -80,4 +123,19 @@ namespace smacc
         postFailureEventFn_();
     }
 
+    const CancellationToken &SmaccAsyncClientBehavior::getCancellationToken() const
+    {
+        return cancellationToken_;
+    }
+
+    bool SmaccAsyncClientBehavior::isCancelled() const
+    {
+        return cancellationToken_.isCancelled();
+    }
+
+    void SmaccAsyncClientBehavior::setExitDeadline(ros::Duration deadline)
+    {
+        exitDeadline_ = deadline;
+    }
+
 } // namespace smacc
@@ -10,12 +10,12 @@ ISmaccClientBehavior::ISmaccClientBehavior()
 
 ISmaccClientBehavior::~ISmaccClientBehavior()
 {
-  ROS_WARN("Client behavior deallocated.");
+  SMACC_TRACE_INFO("Client behavior deallocated.");
 }
 
 std::string ISmaccClientBehavior::getName() const
 {
-  return demangleSymbol(typeid(*this).name());
+  return demangleType(typeid(*this));
 }
 
 void ISmaccClientBehavior::runtimeConfigure()
@@ -35,7 +35,7 @@ void ISmaccComponent::setStateMachine(ISmaccStateMachine *stateMachine)
 
 std::string ISmaccComponent::getName() const
 {
-    std::string keyname = demangleSymbol(typeid(*this).name());
+    std::string keyname = demangleType(typeid(*this));
     return keyname;
 }
 } // namespace smacc
@@ -0,0 +1,97 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#include <smacc/smacc_deferred_event_queue.h>
+#include <smacc/introspection/introspection.h>
+#include <ros/console.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace smacc
+{
+DeferredEventQueue::DeferredEventQueue(std::size_t capacity, Policy policy)
+    : capacity_(capacity), policy_(policy), statistics_{0, 0, 0, 0.0, 0.0}
+{
+}
+
+bool DeferredEventQueue::defer(const EventPtr &ev, unsigned long state, const std::function<bool()> &shouldDefer)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!shouldDefer())
+    {
+        return false;
+    }
+
+    if (entries_.size() >= capacity_)
+    {
+        statistics_.dropped++;
+        if (capacity_ == 0)
+            ROS_WARN_STREAM("CURRENT STATE SCOPED EVENT SKIPPED, state is exiting/transitioning " << introspection::demangleType(typeid(*ev)));
+        else
+            ROS_WARN_STREAM("CURRENT STATE SCOPED EVENT SKIPPED, state is exiting/transitioning and the deferred event queue is full (capacity: "
+                            << capacity_ << ") " << introspection::demangleType(typeid(*ev)));
+        return true;
+    }
+
+    statistics_.deferred++;
+    entries_.push_back(Entry{ev, state, std::chrono::steady_clock::now()});
+    return true;
+}
+
+void DeferredEventQueue::flush(unsigned long currentState, const std::function<void(const EventPtr &)> &post)
+{
+    std::deque<Entry> entries;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (entries_.empty())
+        {
+            return;
+        }
+
+        entries.swap(entries_);
+
+        auto now = std::chrono::steady_clock::now();
+        for (auto &entry : entries)
+        {
+            double seconds = std::chrono::duration<double>(now - entry.deferredAt).count();
+            statistics_.totalDeferredSeconds += seconds;
+            statistics_.maxDeferredSeconds = std::max(statistics_.maxDeferredSeconds, seconds);
+        }
+
+        if (policy_ == Policy::DISCARD)
+        {
+            auto stale = std::remove_if(entries.begin(), entries.end(),
+                                        [currentState](const Entry &entry) { return entry.state != currentState; });
+            statistics_.dropped += std::distance(stale, entries.end());
+            entries.erase(stale, entries.end());
+        }
+
+        statistics_.delivered += entries.size();
+    }
+
+    // posted without the lock, the events may be deferred again
+    for (auto &entry : entries)
+    {
+        post(entry.event);
+    }
+}
+
+DeferredEventStatistics DeferredEventQueue::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+std::size_t DeferredEventQueue::getCapacity() const
+{
+    return capacity_;
+}
+
+DeferredEventQueue::Policy DeferredEventQueue::getPolicy() const
+{
+    return policy_;
+}
+} // namespace smacc
@@ -0,0 +1,127 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#include <smacc/smacc_executor.h>
+#include <ros/ros.h>
+
+#include <algorithm>
+
+namespace smacc
+{
+SmaccExecutor::SmaccExecutor(std::size_t threadCount, double queueWaitWarning)
+    : tasks_(0), totalQueueWait_(0), maxQueueWait_(0),
+      queueWaitWarning_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(std::max(queueWaitWarning, 0.0)))),
+      nextTaskId_(0), stopping_(false), pool_(threadCount)
+{
+    if (queueWaitWarning_.count() > 0)
+    {
+        watchdog_ = std::thread(&SmaccExecutor::watchdogLoop, this);
+    }
+}
+
+SmaccExecutor::~SmaccExecutor()
+{
+    if (watchdog_.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(queuedMutex_);
+            stopping_ = true;
+        }
+        watchdogWakeUp_.notify_all();
+        watchdog_.join();
+    }
+}
+
+void SmaccExecutor::post(std::function<void()> task)
+{
+    auto submitted = std::chrono::steady_clock::now();
+
+    if (!watchdog_.joinable())
+    {
+        pool_.post([this, submitted, task]() {
+            this->recordQueueWait(std::chrono::steady_clock::now() - submitted);
+            task();
+        });
+        return;
+    }
+
+    unsigned long id;
+    {
+        std::lock_guard<std::mutex> lock(queuedMutex_);
+        id = nextTaskId_++;
+        queued_[id] = submitted;
+    }
+
+    pool_.post([this, id, submitted, task]() {
+        {
+            std::lock_guard<std::mutex> lock(queuedMutex_);
+            queued_.erase(id);
+        }
+
+        this->recordQueueWait(std::chrono::steady_clock::now() - submitted);
+        task();
+    });
+}
+
+void SmaccExecutor::recordQueueWait(std::chrono::steady_clock::duration wait)
+{
+    unsigned long nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(wait).count();
+    tasks_.fetch_add(1, std::memory_order_relaxed);
+    totalQueueWait_.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    auto max = maxQueueWait_.load(std::memory_order_relaxed);
+    while (nanoseconds > max && !maxQueueWait_.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+void SmaccExecutor::watchdogLoop()
+{
+    std::unique_lock<std::mutex> lock(queuedMutex_);
+    while (!stopping_)
+    {
+        watchdogWakeUp_.wait_for(lock, queueWaitWarning_ / 2);
+        if (stopping_ || queued_.empty())
+            continue;
+
+        // the tasks are started in any order (work stealing), the lowest id is the oldest queued task
+        auto wait = std::chrono::steady_clock::now() - queued_.begin()->second;
+        if (wait > queueWaitWarning_)
+        {
+            ROS_WARN_THROTTLE(10, "[SmaccExecutor] a task has been waiting %lf seconds for a worker (%lu queued tasks, "
+                                  "%lu threads): the workers are blocked, consider increasing the number of threads",
+                              std::chrono::duration<double>(wait).count(), queued_.size(), pool_.getThreadCount());
+        }
+    }
+}
+
+ExecutorStatistics SmaccExecutor::getStatistics() const
+{
+    ExecutorStatistics statistics;
+    statistics.tasks = tasks_.load(std::memory_order_relaxed);
+    statistics.totalQueueWaitSeconds = totalQueueWait_.load(std::memory_order_relaxed) * 1e-9;
+    statistics.maxQueueWaitSeconds = maxQueueWait_.load(std::memory_order_relaxed) * 1e-9;
+    statistics.pendingTasks = pool_.getPendingTaskCount();
+    statistics.threads = pool_.getThreadCount();
+    return statistics;
+}
+
+SmaccExecutor &SmaccExecutor::getAsyncBehaviorExecutor()
+{
+    // intentionally leaked: behaviors may still be finishing during the static destruction
+    static SmaccExecutor *executor = [] {
+        ros::NodeHandle private_nh("~");
+        int threads;
+        private_nh.param("async_behavior_threads", threads, 8);
+        double queueWaitWarning;
+        private_nh.param("async_behavior_queue_wait_warning", queueWaitWarning, 1.0);
+        ROS_INFO("[SmaccExecutor] asynchronous client behaviors executor: %d threads", threads);
+        return new SmaccExecutor(threads > 0 ? threads : 1, queueWaitWarning);
+    }();
+
+    return *executor;
+}
+} // namespace smacc
@@ -0,0 +1,88 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#include <smacc/smacc_global_data.h>
+
+#include <ros/console.h>
+
+namespace smacc
+{
+GlobalDataStore::GlobalDataStore()
+    : slotTable_(nullptr)
+{
+    std::unique_ptr<const std::vector<Slot *>> emptyTable(new std::vector<Slot *>());
+    slotTable_.store(emptyTable.get(), std::memory_order_release);
+    slotTableVersions_.push_back(std::move(emptyTable));
+}
+
+GlobalDataStore::~GlobalDataStore()
+{
+}
+
+int GlobalDataStore::intern(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(keysMutex_);
+    auto it = keys_.find(name);
+    if (it != keys_.end())
+        return it->second;
+
+    std::unique_ptr<Slot> slot(new Slot());
+    slot->name = name;
+    slot->version = 0;
+
+    // copy on write: the readers of the current table are not disturbed
+    auto *current = slotTable_.load(std::memory_order_acquire);
+    std::unique_ptr<std::vector<Slot *>> table(new std::vector<Slot *>(*current));
+    table->push_back(slot.get());
+
+    int index = table->size() - 1;
+    slots_.push_back(std::move(slot));
+    keys_[name] = index;
+
+    slotTable_.store(table.get(), std::memory_order_release);
+    slotTableVersions_.push_back(std::move(table));
+    return index;
+}
+
+int GlobalDataStore::find(const std::string &name) const
+{
+    std::lock_guard<std::mutex> lock(keysMutex_);
+    auto it = keys_.find(name);
+    if (it == keys_.end())
+        return -1;
+
+    return it->second;
+}
+
+std::size_t GlobalDataStore::size() const
+{
+    return slotTable_.load(std::memory_order_acquire)->size();
+}
+
+GlobalDataStore::Slot *GlobalDataStore::getSlot(int index) const
+{
+    auto *table = slotTable_.load(std::memory_order_acquire);
+    if (index < 0 || (std::size_t)index >= table->size())
+        return nullptr;
+
+    return (*table)[index];
+}
+
+GlobalDataStore::Slot *GlobalDataStore::getKeySlot(int index, const GlobalDataStore *store) const
+{
+    if (store != this)
+    {
+        ROS_ERROR("Incorrect global data key (index %d): it is not initialized or it belongs to other state machine",
+                  index);
+        return nullptr;
+    }
+
+    auto *slot = this->getSlot(index);
+    if (slot == nullptr)
+        ROS_ERROR("Incorrect global data key: index %d out of range (%lu variables)", index, this->size());
+
+    return slot;
+}
+} // namespace smacc
@@ -0,0 +1,144 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#include <smacc/smacc_lock_profiler.h>
+#include <ros/console.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+namespace smacc
+{
+namespace lock_profiler_detail
+{
+std::atomic<bool> enabled(false);
+
+namespace
+{
+std::mutex &getSitesMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+// intentionally leaked, the sites are never destroyed
+std::vector<const LockSite *> &getSites()
+{
+    static auto *sites = new std::vector<const LockSite *>();
+    return *sites;
+}
+
+double toSeconds(unsigned long nanoseconds)
+{
+    return nanoseconds * 1e-9;
+}
+} // namespace
+} // namespace lock_profiler_detail
+
+using namespace lock_profiler_detail;
+
+LockSite::LockSite(const char *name)
+    : name_(name), acquisitions_(0), contentions_(0), totalWait_(0), totalHold_(0), maxHold_(0)
+{
+    std::lock_guard<std::mutex> lock(getSitesMutex());
+    getSites().push_back(this);
+}
+
+void LockSite::addAcquisition(bool contended, std::chrono::steady_clock::duration wait)
+{
+    acquisitions_.fetch_add(1, std::memory_order_relaxed);
+    if (contended)
+    {
+        contentions_.fetch_add(1, std::memory_order_relaxed);
+        totalWait_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(wait).count(), std::memory_order_relaxed);
+    }
+}
+
+void LockSite::addHold(std::chrono::steady_clock::duration hold)
+{
+    unsigned long nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(hold).count();
+    totalHold_.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    auto max = maxHold_.load(std::memory_order_relaxed);
+    while (nanoseconds > max && !maxHold_.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+LockSiteStatistics LockSite::getStatistics() const
+{
+    LockSiteStatistics statistics;
+    statistics.name = name_;
+    statistics.acquisitions = acquisitions_.load(std::memory_order_relaxed);
+    statistics.contentions = contentions_.load(std::memory_order_relaxed);
+    statistics.totalWaitSeconds = toSeconds(totalWait_.load(std::memory_order_relaxed));
+    statistics.totalHoldSeconds = toSeconds(totalHold_.load(std::memory_order_relaxed));
+    statistics.maxHoldSeconds = toSeconds(maxHold_.load(std::memory_order_relaxed));
+    return statistics;
+}
+
+void setLockProfilingEnabled(bool enabled)
+{
+    lock_profiler_detail::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool isLockProfilingEnabled()
+{
+    return lock_profiler_detail::enabled.load(std::memory_order_relaxed);
+}
+
+std::vector<LockSiteStatistics> getLockStatistics()
+{
+    // the same site of a template is a different static object for each instantiation
+    std::map<std::string, LockSiteStatistics> merged;
+    {
+        std::lock_guard<std::mutex> lock(getSitesMutex());
+        for (auto *site : getSites())
+        {
+            auto statistics = site->getStatistics();
+            auto it = merged.find(statistics.name);
+            if (it == merged.end())
+            {
+                merged.emplace(statistics.name, statistics);
+            }
+            else
+            {
+                auto &total = it->second;
+                total.acquisitions += statistics.acquisitions;
+                total.contentions += statistics.contentions;
+                total.totalWaitSeconds += statistics.totalWaitSeconds;
+                total.totalHoldSeconds += statistics.totalHoldSeconds;
+                total.maxHoldSeconds = std::max(total.maxHoldSeconds, statistics.maxHoldSeconds);
+            }
+        }
+    }
+
+    std::vector<LockSiteStatistics> result;
+    for (auto &item : merged)
+    {
+        result.push_back(item.second);
+    }
+
+    std::sort(result.begin(), result.end(), [](const LockSiteStatistics &a, const LockSiteStatistics &b) {
+        return a.totalHoldSeconds > b.totalHoldSeconds;
+    });
+    return result;
+}
+
+void reportLockStatistics()
+{
+    for (auto &statistics : getLockStatistics())
+    {
+        if (statistics.acquisitions == 0)
+            continue;
+
+        ROS_INFO("Lock site '%s' - acquisitions: %lu, contended: %lu, wait: %.6f s, hold: %.6f s (mean %.6f s, max %.6f s)",
+                 statistics.name.c_str(), statistics.acquisitions, statistics.contentions, statistics.totalWaitSeconds,
+                 statistics.totalHoldSeconds, statistics.totalHoldSeconds / statistics.acquisitions,
+                 statistics.maxHoldSeconds);
+    }
+}
+} // namespace smacc
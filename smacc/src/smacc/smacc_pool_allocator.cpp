@@ -0,0 +1,24 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#include <smacc/smacc_pool_allocator.h>
+
+namespace smacc
+{
+namespace pool_detail
+{
+std::atomic<unsigned long> totalHits(0);
+std::atomic<unsigned long> totalMisses(0);
+std::atomic<long> totalCached(0);
+} // namespace pool_detail
+
+SmaccPoolStatistics getPoolStatistics()
+{
+  long cached = pool_detail::totalCached.load(std::memory_order_relaxed);
+  return SmaccPoolStatistics{pool_detail::totalHits.load(std::memory_order_relaxed),
+                             pool_detail::totalMisses.load(std::memory_order_relaxed),
+                             (unsigned long)(cached > 0 ? cached : 0)};
+}
+} // namespace smacc
@@ -5,12 +5,12 @@ namespace smacc
 {
 std::string ISmaccState::getClassName()
 {
-    return demangleSymbol(typeid(*this).name());
+    return demangleType(typeid(*this));
 }
 
 void ISmaccState::notifyTransitionFromTransitionTypeInfo(TypeInfo::Ptr &transitionType)
 {
-    ROS_INFO_STREAM("NOTIFY TRANSITION: " << transitionType->getFullName());
+    SMACC_TRACE_INFO_STREAM("NOTIFY TRANSITION: " << transitionType->getFullName());
 
     //auto currstateinfo = this->getStateMachine().getCurrentStateInfo();
     auto currstateinfo = this->stateInfo_;
@@ -9,11 +9,13 @@
 #include <smacc/client_bases/smacc_action_client.h>
 #include <smacc_msgs/SmaccStatus.h>
 #include <smacc_msgs/SmaccTransitionLogEntry.h>
+#include <ros/serialization.h>
 namespace smacc
 {
 using namespace smacc::introspection;
 ISmaccStateMachine::ISmaccStateMachine(SignalDetector *signalDetector)
-    : private_nh_("~"), currentState_(nullptr), stateSeqCounter_(0)
+    : private_nh_("~"), currentState_(nullptr), orthogonalTable_(nullptr), stateMachineCurrentAction(StateMachineInternalAction::TRANSITIONING),
+      currentStateIndex_(-1), statusDeltaSequence_(0), descriptionHash_(0), stateSeqCounter_(0)
 {
     ROS_INFO("Creating State Machine Base");
     signalDetector_ = signalDetector;
@@ -39,11 +41,109 @@ ISmaccStateMachine::ISmaccStateMachine(SignalDetector *signalDetector)
     {
         runMode_ = SMRunMode::DEBUG;
     }
+
+    double globalDataMaxPublishRate;
+    private_nh_.param("global_data_max_publish_rate", globalDataMaxPublishRate, 0.0);
+    globalDataMinPublishPeriod_ = ros::Duration(globalDataMaxPublishRate > 0 ? 1.0 / globalDataMaxPublishRate : 0.0);
+
+    int deferredEventsCapacity;
+    std::string deferredEventsPolicy;
+    private_nh_.param("deferred_events_capacity", deferredEventsCapacity, 100);
+    private_nh_.param("deferred_events_policy", deferredEventsPolicy, std::string("discard"));
+
+    auto policy = DeferredEventQueue::Policy::DISCARD;
+    if (deferredEventsPolicy == "deliver")
+    {
+        policy = DeferredEventQueue::Policy::DELIVER;
+    }
+    else if (deferredEventsPolicy != "discard")
+    {
+        ROS_ERROR("Incorrect deferred_events_policy value: %s (expected discard or deliver)", deferredEventsPolicy.c_str());
+    }
+
+    deferredEvents_.reset(new DeferredEventQueue(std::max(deferredEventsCapacity, 0), policy));
+
+    private_nh_.param("parallel_orthogonals", parallelOrthogonals_, false);
+    private_nh_.param("parallel_orthogonals_threads", parallelOrthogonalsThreads_, 0);
+
+    double asyncBehaviorExitDeadline;
+    private_nh_.param("async_behavior_exit_deadline", asyncBehaviorExitDeadline, 0.0);
+    asyncBehaviorExitDeadline_ = ros::Duration(std::max(asyncBehaviorExitDeadline, 0.0));
+
+    private_nh_.param("print_statistics", printStatistics_, false);
+
+    bool lockProfiling;
+    private_nh_.param("lock_profiling", lockProfiling, false);
+    if (lockProfiling)
+    {
+        setLockProfilingEnabled(true);
+    }
 }
 
 ISmaccStateMachine::~ISmaccStateMachine()
 {
     ROS_INFO("Finishing State Machine");
+
+    if (printStatistics_)
+    {
+        auto poolStats = smacc::getPoolStatistics();
+        ROS_INFO("Event/state pool statistics - hits: %lu, misses: %lu, cached: %lu", poolStats.hits, poolStats.misses, poolStats.cached);
+
+        auto deferredStats = deferredEvents_->getStatistics();
+        ROS_INFO("Deferred current state events - deferred: %lu, delivered: %lu, dropped: %lu, time deferred: %.6f s (max %.6f s)",
+                 deferredStats.deferred, deferredStats.delivered, deferredStats.dropped, deferredStats.totalDeferredSeconds,
+                 deferredStats.maxDeferredSeconds);
+
+        for (auto &latency : this->getOrthogonalLatencyStatistics())
+        {
+            ROS_INFO("Orthogonal %s - entries: %lu (mean %.6f s, max %.6f s), exits: %lu (mean %.6f s, max %.6f s)",
+                     latency.orthogonal.c_str(), latency.entries, latency.entries ? latency.totalEntrySeconds / latency.entries : 0.0,
+                     latency.maxEntrySeconds, latency.exits, latency.exits ? latency.totalExitSeconds / latency.exits : 0.0,
+                     latency.maxExitSeconds);
+        }
+
+        for (auto &exit : this->getAsyncBehaviorExitStatistics())
+        {
+            ROS_INFO("Asynchronous behavior %s - exits: %lu, exit delay: mean %.6f s, max %.6f s, expired deadlines: %lu",
+                     exit.behavior.c_str(), exit.exits, exit.exits ? exit.totalDelaySeconds / exit.exits : 0.0,
+                     exit.maxDelaySeconds, exit.expiredDeadlines);
+        }
+    }
+
+    if (isLockProfilingEnabled())
+    {
+        reportLockStatistics();
+    }
+}
+
+void ISmaccStateMachine::addStateCallbackConnection(const boost::signals2::connection &connection)
+{
+    ProfiledLockGuard<std::mutex> lock(stateCallbackConnectionsMutex_, SMACC_LOCK_SITE("ISmaccStateMachine::createSignalConnection"));
+    stateCallbackConnections.push_back(connection);
+}
+
+void ISmaccStateMachine::addStateCallbackConnection(const SmaccLightConnection &connection)
+{
+    ProfiledLockGuard<std::mutex> lock(stateCallbackConnectionsMutex_, SMACC_LOCK_SITE("ISmaccStateMachine::createSignalConnection"));
+    stateLightCallbackConnections_.push_back(connection);
+}
+
+void ISmaccStateMachine::registerUpdatableClient(ISmaccUpdatable *updatable)
+{
+    if (updatable != nullptr)
+        signalDetector_->registerUpdatableClient(updatable);
+}
+
+void ISmaccStateMachine::registerUpdatableStateElement(ISmaccUpdatable *updatable, ISmaccState *ownerState)
+{
+    if (updatable != nullptr)
+        signalDetector_->registerUpdatableStateElement(updatable, ownerState);
+}
+
+void ISmaccStateMachine::unregisterUpdatableStateElement(ISmaccUpdatable *updatable)
+{
+    if (updatable != nullptr)
+        signalDetector_->unregisterUpdatableStateElement(updatable);
 }
 
 void ISmaccStateMachine::reset()
@@ -65,12 +165,11 @@ const std::map<std::string, std::shared_ptr<smacc::ISmaccOrthogonal>> &ISmaccSta
 
 void ISmaccStateMachine::updateStatusMessage()
 {
-    std::lock_guard<std::recursive_mutex> lock(m_mutex_);
+    ProfiledLockGuard<std::mutex> lock(statusMutex_, SMACC_LOCK_SITE("ISmaccStateMachine::updateStatusMessage"));
 
     if (currentStateInfo_ != nullptr)
     {
-        ROS_WARN_STREAM("[StateMachine] setting state active "
-                        << ": " << currentStateInfo_->getFullPath());
+        SMACC_TRACE_INFO("[StateMachine] setting state active : %s", currentStateInfo_->getFullPath().c_str());
 
         if (this->runMode_ == SMRunMode::DEBUG)
         {
@@ -83,28 +182,99 @@ void ISmaccStateMachine::updateStatusMessage()
                 status_msg_.current_states.push_back(ancestor->toShortName());
             }
 
-            status_msg_.global_variable_names.clear();
-            status_msg_.global_variable_values.clear();
-
-            for (auto entry : this->globalData_)
-            {
-                status_msg_.global_variable_names.push_back(entry.first);
-                status_msg_.global_variable_values.push_back(entry.second.first()); // <- invoke to_string()
-            }
-
+            // the global variable values of the status message are refreshed by the status delta timer
+            this->updateGlobalDataStatus();
             status_msg_.header.stamp = ros::Time::now();
             status_msg_.header.frame_id = "odom";
             this->stateMachineStatusPub_.publish(status_msg_);
+
+            smacc_msgs::SmaccStatusDelta delta;
+            delta.header = status_msg_.header;
+            delta.sequence = statusDeltaSequence_++;
+            delta.states_changed = true;
+            delta.current_states = status_msg_.current_states;
+            this->stateMachineStatusDeltaPub_.publish(delta);
         }
     }
 }
 
+void ISmaccStateMachine::updateGlobalDataStatus()
+{
+    auto count = globalData_.size();
+    for (auto i = globalDataStatus_.size(); i < count; i++)
+    {
+        GlobalDataStatus status;
+        status.minPublishPeriod = globalDataMinPublishPeriod_;
+        globalDataStatus_.push_back(status);
+
+        status_msg_.global_variable_names.push_back(globalData_.getSlot(i)->name);
+        status_msg_.global_variable_values.push_back("");
+    }
+}
+
+void ISmaccStateMachine::setGlobalSMDataMaxPublishRate(std::string name, double hz)
+{
+    int index = globalData_.intern(name);
+
+    ProfiledLockGuard<std::mutex> lock(statusMutex_, SMACC_LOCK_SITE("ISmaccStateMachine::setGlobalSMDataMaxPublishRate"));
+    this->updateGlobalDataStatus();
+    globalDataStatus_[index].minPublishPeriod = ros::Duration(hz > 0 ? 1.0 / hz : 0.0);
+}
+
+void ISmaccStateMachine::publishStatusDelta(const ros::TimerEvent &)
+{
+    ProfiledLockGuard<std::mutex> lock(statusMutex_, SMACC_LOCK_SITE("ISmaccStateMachine::publishStatusDelta"));
+    if (this->runMode_ != SMRunMode::DEBUG)
+        return;
+
+    this->updateGlobalDataStatus();
+
+    smacc_msgs::SmaccStatusDelta delta;
+    auto now = ros::Time::now();
+
+    for (std::size_t i = 0; i < globalDataStatus_.size(); i++)
+    {
+        auto &status = globalDataStatus_[i];
+        auto &slot = *globalData_.getSlot(i);
+
+        auto version = slot.version.load(std::memory_order_acquire);
+        if (version == status.publishedVersion || now < status.lastPublished + status.minPublishPeriod)
+            continue;
+
+        auto record = std::atomic_load(&slot.record);
+        status.publishedVersion = version;
+        status.lastPublished = now;
+
+        auto &value = status_msg_.global_variable_values[i];
+        value = record->toString(*record);
+
+        delta.global_variable_names.push_back(slot.name);
+        delta.global_variable_values.push_back(value);
+    }
+
+    if (!delta.global_variable_names.empty())
+    {
+        delta.header.stamp = now;
+        delta.header.frame_id = "odom";
+        delta.sequence = statusDeltaSequence_++;
+        delta.states_changed = false;
+        this->stateMachineStatusDeltaPub_.publish(delta);
+
+        // the latched status is kept up to date for the late subscribers and the viewers of the full status
+        status_msg_.header = delta.header;
+        this->stateMachineStatusPub_.publish(status_msg_);
+    }
+}
+
 void ISmaccStateMachine::publishTransition(const SmaccTransitionInfo &transitionInfo)
 {
     smacc_msgs::SmaccTransitionLogEntry transitionLogEntry;
     transitionLogEntry.timestamp = ros::Time::now();
     transitionInfoToMsg(transitionInfo, transitionLogEntry.transition);
-    this->transitionLogHistory_.push_back(transitionLogEntry);
+    if (transitionLog_ != nullptr)
+    {
+        transitionLog_->append(transitionLogEntry);
+    }
 
     transitionLogPub_.publish(transitionLogEntry);
 }
@@ -116,54 +286,303 @@ void ISmaccStateMachine::onInitialize()
 void ISmaccStateMachine::onInitialized()
 {
     timer_ = nh_.createTimer(ros::Duration(0.5), &ISmaccStateMachine::state_machine_visualization, this);
+
+    double statusDeltaRate;
+    private_nh_.param("status_delta_rate", statusDeltaRate, 10.0);
+    statusDeltaTimer_ = nh_.createTimer(ros::Duration(1.0 / std::max(statusDeltaRate, 0.1)), &ISmaccStateMachine::publishStatusDelta, this);
 }
 
 void ISmaccStateMachine::initializeROS(std::string shortname)
 {
     ROS_WARN_STREAM("State machine base creation:" << shortname);
     // STATE MACHINE TOPICS
-    stateMachinePub_ = nh_.advertise<smacc_msgs::SmaccStateMachine>(shortname + "/smacc/state_machine_description", 1);
-    stateMachineStatusPub_ = nh_.advertise<smacc_msgs::SmaccStatus>(shortname + "/smacc/status", 1);
+    // the description and the status are latched, the heartbeat tells the late subscribers if they are up to date
+    stateMachinePub_ = nh_.advertise<smacc_msgs::SmaccStateMachine>(shortname + "/smacc/state_machine_description", 1, true);
+    stateMachineStatusPub_ = nh_.advertise<smacc_msgs::SmaccStatus>(shortname + "/smacc/status", 1, true);
+    heartbeatPub_ = nh_.advertise<smacc_msgs::SmaccHeartbeat>(shortname + "/smacc/heartbeat", 1);
+    stateMachineStatusDeltaPub_ = nh_.advertise<smacc_msgs::SmaccStatusDelta>(shortname + "/smacc/status_delta", 100);
     transitionLogPub_ = nh_.advertise<smacc_msgs::SmaccTransitionLogEntry>(shortname + "/smacc/transition_log", 1);
 
+    int transitionLogCapacity;
+    std::string transitionLogSpillFile;
+    private_nh_.param("transition_log_capacity", transitionLogCapacity, 1024);
+    private_nh_.param("transition_log_spill_file", transitionLogSpillFile, std::string(""));
+    transitionLog_.reset(new TransitionLog(std::max(transitionLogCapacity, 1), transitionLogSpillFile));
+
+    // the state machine structure does not change after the introspection (buildStateMachineInfo)
+    smacc_msgs::SmaccStateMachine state_machine_msg;
+    state_machine_msg.states = stateMachineInfo_->stateMsgs;
+    state_machine_msg.content_hash = 0;
+
+    uint32_t size = ros::serialization::serializationLength(state_machine_msg.states);
+    std::vector<uint8_t> buffer(size);
+    ros::serialization::OStream stream(buffer.data(), size);
+    ros::serialization::serialize(stream, state_machine_msg.states);
+
+    // FNV-1a
+    descriptionHash_ = 14695981039346656037ULL;
+    for (auto byte : buffer)
+    {
+        descriptionHash_ = (descriptionHash_ ^ byte) * 1099511628211ULL;
+    }
+
+    state_machine_msg.content_hash = descriptionHash_;
+    stateMachinePub_.publish(state_machine_msg);
+
     // STATE MACHINE SERVICES
     transitionHistoryService_ = nh_.advertiseService(shortname + "/smacc/transition_log_history", &ISmaccStateMachine::getTransitionLogHistory, this);
 }
 
 bool ISmaccStateMachine::getTransitionLogHistory(smacc_msgs::SmaccGetTransitionHistory::Request &req, smacc_msgs::SmaccGetTransitionHistory::Response &res)
 {
-    ROS_WARN("Requesting Transition Log History, current size: %ld", this->transitionLogHistory_.size());
-    res.history = this->transitionLogHistory_;
+    if (transitionLog_ == nullptr)
+    {
+        return false;
+    }
+
+    ROS_DEBUG("Requesting Transition Log History since %lu (max entries: %u), logged transitions: %lu",
+              (unsigned long)req.since_sequence, req.max_entries, (unsigned long)transitionLog_->getNextSequence());
+
+    uint64_t nextSequence;
+    res.first_sequence = transitionLog_->read(req.since_sequence, req.max_entries, res.history, nextSequence);
+    res.next_sequence = nextSequence;
     return true;
 }
 
 void ISmaccStateMachine::state_machine_visualization(const ros::TimerEvent &)
 {
-    std::lock_guard<std::recursive_mutex> lock(m_mutex_);
+    smacc_msgs::SmaccHeartbeat heartbeat;
+    heartbeat.header.stamp = ros::Time::now();
+    heartbeat.description_hash = descriptionHash_;
+    heartbeat.current_state_index = currentStateIndex_.load();
+    this->heartbeatPub_.publish(heartbeat);
+}
 
-    smacc_msgs::SmaccStateMachine state_machine_msg;
-    state_machine_msg.states = stateMachineInfo_->stateMsgs;
-    this->stateMachinePub_.publish(state_machine_msg);
+void ISmaccStateMachine::refreshStateReactorDispatchTable()
+{
+    std::shared_ptr<StateReactorDispatchTable> dispatchTable;
+    if (currentState_ != nullptr)
+    {
+        // inner states first, as the event propagation of statechart
+        dispatchTable = std::make_shared<StateReactorDispatchTable>();
+        for (auto *state = currentState_; state != nullptr; state = state->getParentState())
+        {
+            for (auto &sr : state->getStateReactors())
+            {
+                dispatchTable->addStateReactor(sr);
+            }
+        }
+    }
+
+    std::atomic_store(&stateReactorDispatchTable_, std::shared_ptr<const StateReactorDispatchTable>(dispatchTable));
+}
+
+void ISmaccStateMachine::notifyStateReactors(const boost::statechart::event_base &ev)
+{
+    auto dispatchTable = std::atomic_load(&stateReactorDispatchTable_);
+    if (dispatchTable == nullptr)
+        return;
+
+    auto *stateReactors = dispatchTable->find(ev.dynamic_type());
+    if (stateReactors == nullptr)
+        return;
+
+    for (auto &sr : *stateReactors)
+    {
+        try
+        {
+            sr->notifyEvent(ev);
+        }
+        catch (const std::exception &e)
+        {
+            ROS_ERROR("[State Reactor %s] Exception on event notification - continuing with next state reactor. Exception info: %s",
+                      demangleType(typeid(*sr)).c_str(), e.what());
+        }
+    }
+}
+
+void ISmaccStateMachine::runOnStateMachineThread(std::function<void()> task)
+{
+    auto *ev = new EvStateMachineTask();
+    ev->task = std::move(task);
+    this->signalDetector_->postEvent(ev);
+}
+
+void ISmaccStateMachine::runStateMachineTask(const EvStateMachineTask &ev)
+{
+    try
+    {
+        ev.task();
+    }
+    catch (const std::exception &e)
+    {
+        ROS_ERROR("[StateMachine] Exception on state machine task: %s", e.what());
+    }
+}
+
+void ISmaccStateMachine::flushDeferredEvents()
+{
+    deferredEvents_->flush(this->getCurrentStateCounter(), [this](const DeferredEventQueue::EventPtr &ev) {
+        SMACC_TRACE_DEBUG("[StateMachine] delivering deferred event: %s", demangleType(typeid(*ev)).c_str());
+        this->signalDetector_->postEvent(ev);
+    });
+}
+
+DeferredEventStatistics ISmaccStateMachine::getDeferredEventStatistics() const
+{
+    return deferredEvents_->getStatistics();
+}
+
+void ISmaccStateMachine::executeOrthogonals(bool entry)
+{
+    const char *phase = entry ? "onEntry" : "onExit";
+
+    std::vector<ISmaccOrthogonal *> orthogonals;
+    orthogonals.reserve(orthogonals_.size());
+    for (auto &pair : orthogonals_)
+    {
+        orthogonals.push_back(pair.second.get());
+    }
+
+    std::vector<double> durations(orthogonals.size(), 0.0);
+
+    auto execute = [phase, entry](ISmaccOrthogonal *orthogonal, double &duration) {
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+            if (entry)
+                orthogonal->onEntry();
+            else
+                orthogonal->onExit();
+        }
+        catch (const std::exception &e)
+        {
+            ROS_ERROR("[Orthogonal %s] Exception on %s - continuing with next orthogonal. Exception info: %s",
+                      orthogonal->getName().c_str(), phase, e.what());
+        }
+        duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    if (parallelOrthogonals_ && orthogonals.size() > 1)
+    {
+        if (orthogonalThreadPool_ == nullptr)
+        {
+            auto threads = parallelOrthogonalsThreads_ > 0 ? parallelOrthogonalsThreads_ : orthogonals.size();
+            orthogonalThreadPool_.reset(new SmaccThreadPool(threads));
+        }
+
+        std::vector<std::future<void>> pending;
+        pending.reserve(orthogonals.size());
+        for (std::size_t i = 0; i < orthogonals.size(); i++)
+        {
+            auto *orthogonal = orthogonals[i];
+            auto *duration = &durations[i];
+            pending.push_back(orthogonalThreadPool_->submit([execute, orthogonal, duration]() { execute(orthogonal, *duration); }));
+        }
+
+        // join barrier: every task is waited for before an exception (not caught by execute) is propagated, as in
+        // the sequential execution
+        std::exception_ptr error;
+        for (auto &task : pending)
+        {
+            try
+            {
+                task.get();
+            }
+            catch (...)
+            {
+                if (error == nullptr)
+                    error = std::current_exception();
+            }
+        }
+
+        if (error != nullptr)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+    else
+    {
+        for (std::size_t i = 0; i < orthogonals.size(); i++)
+        {
+            execute(orthogonals[i], durations[i]);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(orthogonalLatencyMutex_);
+    for (std::size_t i = 0; i < orthogonals.size(); i++)
+    {
+        SMACC_TRACE_DEBUG("[Orthogonal %s] %s took %.6f s", orthogonals[i]->getName().c_str(), phase, durations[i]);
+
+        auto &latency = orthogonalLatency_[orthogonals[i]->getName()];
+        if (entry)
+        {
+            latency.entries++;
+            latency.lastEntrySeconds = durations[i];
+            latency.maxEntrySeconds = std::max(latency.maxEntrySeconds, durations[i]);
+            latency.totalEntrySeconds += durations[i];
+        }
+        else
+        {
+            latency.exits++;
+            latency.lastExitSeconds = durations[i];
+            latency.maxExitSeconds = std::max(latency.maxExitSeconds, durations[i]);
+            latency.totalExitSeconds += durations[i];
+        }
+    }
+}
+
+std::vector<OrthogonalLatencyStatistics> ISmaccStateMachine::getOrthogonalLatencyStatistics()
+{
+    std::lock_guard<std::mutex> lock(orthogonalLatencyMutex_);
+    std::vector<OrthogonalLatencyStatistics> result;
+    for (auto &item : orthogonalLatency_)
+    {
+        result.push_back(item.second);
+        result.back().orthogonal = item.first;
+    }
+
+    return result;
+}
+
+void ISmaccStateMachine::addAsyncBehaviorExitDelay(const std::string &behavior, double seconds, bool deadlineExpired)
+{
+    std::lock_guard<std::mutex> lock(asyncBehaviorExitMutex_);
+    auto &exit = asyncBehaviorExit_[behavior];
+    exit.exits++;
+    exit.lastDelaySeconds = seconds;
+    exit.maxDelaySeconds = std::max(exit.maxDelaySeconds, seconds);
+    exit.totalDelaySeconds += seconds;
+    if (deadlineExpired)
+        exit.expiredDeadlines++;
+}
+
+std::vector<AsyncBehaviorExitStatistics> ISmaccStateMachine::getAsyncBehaviorExitStatistics()
+{
+    std::lock_guard<std::mutex> lock(asyncBehaviorExitMutex_);
+    std::vector<AsyncBehaviorExitStatistics> result;
+    for (auto &item : asyncBehaviorExit_)
+    {
+        result.push_back(item.second);
+        result.back().behavior = item.first;
+    }
 
-    status_msg_.header.stamp = ros::Time::now();
-    this->stateMachineStatusPub_.publish(status_msg_);
+    return result;
 }
 
-void ISmaccStateMachine::lockStateMachine(std::string msg)
+void ISmaccStateMachine::lockStateMachine(LockSite &site)
 {
-    ROS_DEBUG("locking state machine: %s", msg.c_str());
-    m_mutex_.lock();
+    updateMutex_.lock(site);
 }
 
-void ISmaccStateMachine::unlockStateMachine(std::string msg)
+void ISmaccStateMachine::unlockStateMachine()
 {
-    ROS_DEBUG("unlocking state machine: %s", msg.c_str());
-    m_mutex_.unlock();
+    updateMutex_.unlock();
 }
 
 std::string ISmaccStateMachine::getStateMachineName()
 {
-    return demangleSymbol(typeid(*this).name());
+    return demangleType(typeid(*this));
 }
 
 void ISmaccStateMachine::checkStateMachineConsistence()
@@ -84,7 +84,7 @@ namespace smacc
                 smacc_msgs::SmaccOrthogonal orthogonalMsg;
 
                 const auto *orthogonaltid = &typeid(*(orthogonal.second));
-                orthogonalMsg.name = demangleSymbol(orthogonaltid->name());
+                orthogonalMsg.name = demangleType(orthogonaltid);
 
                 ss << " - orthogonal: " << orthogonalMsg.name << std::endl;
 
@@ -93,7 +93,7 @@ namespace smacc
                     auto &behaviors = smaccBehaviorInfoMappingByOrthogonalType[orthogonaltid];
                     for (auto &bhinfo : behaviors)
                     {
-                        auto ClientBehaviorName = demangleSymbol(bhinfo->behaviorType->name());
+                        auto ClientBehaviorName = demangleType(bhinfo->behaviorType);
                         orthogonalMsg.client_behavior_names.push_back(ClientBehaviorName);
                         ss << "          - client behavior: " << ClientBehaviorName << std::endl;
                     }
@@ -129,7 +129,7 @@ namespace smacc
                 {
                     smacc_msgs::SmaccEventGenerator eventGeneratorMsg;
                     eventGeneratorMsg.index = k++;
-                    eventGeneratorMsg.type_name = demangleSymbol(eginfo->eventGeneratorType->name());
+                    eventGeneratorMsg.type_name = demangleType(eginfo->eventGeneratorType);
 
                     ss << " - event generator: " << eventGeneratorMsg.type_name << std::endl;
                     if (eginfo->objectTagType != nullptr)
@@ -149,7 +149,7 @@ namespace smacc
                 {
                     smacc_msgs::SmaccStateReactor stateReactorMsg;
                     stateReactorMsg.index = k++;
-                    stateReactorMsg.type_name = demangleSymbol(srinfo->stateReactorType->name());
+                    stateReactorMsg.type_name = demangleType(srinfo->stateReactorType);
 
                     ss << " - state reactor: " << stateReactorMsg.type_name << std::endl;
                     if (srinfo->objectTagType != nullptr)
@@ -0,0 +1,157 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#include <smacc/smacc_thread_pool.h>
+
+#include <algorithm>
+
+namespace smacc
+{
+namespace
+{
+// pool and queue index of the current worker thread
+thread_local const SmaccThreadPool *currentPool = nullptr;
+thread_local std::size_t currentWorkerIndex = 0;
+} // namespace
+
+SmaccThreadPool::SmaccThreadPool(std::size_t threadCount)
+    : queuedTasks_(0), pendingTasks_(0), nextQueue_(0), stealCount_(0), stopping_(false)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (std::size_t i = 0; i < threadCount; i++)
+    {
+        queues_.emplace_back(new WorkerQueue());
+    }
+
+    for (std::size_t i = 0; i < threadCount; i++)
+    {
+        workers_.emplace_back(&SmaccThreadPool::workerLoop, this, i);
+    }
+}
+
+SmaccThreadPool::~SmaccThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(waitMutex_);
+        stopping_ = true;
+    }
+    taskAvailable_.notify_all();
+
+    for (auto &worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+void SmaccThreadPool::post(std::function<void()> task)
+{
+    std::size_t index;
+    if (isWorkerThread())
+        index = currentWorkerIndex;
+    else
+        index = nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+
+    pendingTasks_++;
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+
+    {
+        // the counter is modified with the wait mutex locked so that the notification is not lost
+        std::lock_guard<std::mutex> lock(waitMutex_);
+        queuedTasks_++;
+    }
+    taskAvailable_.notify_one();
+}
+
+bool SmaccThreadPool::tryGetTask(std::size_t index, std::function<void()> &task)
+{
+    {
+        // own queue: newest task first
+        auto &queue = *queues_[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // steal the oldest task of the other queues
+    for (std::size_t i = 1; i < queues_.size(); i++)
+    {
+        auto &queue = *queues_[(index + i) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            stealCount_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void SmaccThreadPool::workerLoop(std::size_t index)
+{
+    currentPool = this;
+    currentWorkerIndex = index;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(waitMutex_);
+            taskAvailable_.wait(lock, [&] { return queuedTasks_ > 0 || stopping_; });
+
+            if (queuedTasks_ == 0 && stopping_)
+            {
+                return;
+            }
+
+            // this worker takes the responsibility of executing one of the queued tasks
+            queuedTasks_--;
+        }
+
+        std::function<void()> task;
+        while (!tryGetTask(index, task))
+        {
+            // the task was pushed into some queue but it may have been taken by other worker meanwhile,
+            // in that case that worker is going to execute a different one (the counter keeps the balance)
+            std::this_thread::yield();
+        }
+
+        task();
+        pendingTasks_--;
+    }
+}
+
+std::size_t SmaccThreadPool::getThreadCount() const
+{
+    return workers_.size();
+}
+
+std::size_t SmaccThreadPool::getPendingTaskCount() const
+{
+    return pendingTasks_;
+}
+
+unsigned long SmaccThreadPool::getStealCount() const
+{
+    return stealCount_;
+}
+
+bool SmaccThreadPool::isWorkerThread() const
+{
+    return currentPool == this;
+}
+} // namespace smacc
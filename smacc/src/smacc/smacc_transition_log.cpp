@@ -0,0 +1,130 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#include <smacc/smacc_transition_log.h>
+
+#include <ros/ros.h>
+#include <ros/serialization.h>
+
+#include <algorithm>
+
+namespace smacc
+{
+TransitionLog::TransitionLog(std::size_t capacity, std::string spillFilePath)
+    : slots_(std::max<std::size_t>(capacity, 1)), nextSequence_(0)
+{
+    if (!spillFilePath.empty())
+    {
+        spillFile_.open(spillFilePath, std::ios::binary | std::ios::app);
+        if (!spillFile_.is_open())
+        {
+            ROS_ERROR("[TransitionLog] cannot open the transition log spill file: %s", spillFilePath.c_str());
+        }
+    }
+}
+
+TransitionLog::~TransitionLog()
+{
+    if (spillFile_.is_open())
+    {
+        // the entries still in the ring are also stored, so that the file contains the whole history
+        auto next = nextSequence_.load(std::memory_order_acquire);
+        for (auto sequence = this->getOldestSequence(); sequence < next; sequence++)
+        {
+            auto record = std::atomic_load(&slots_[sequence % slots_.size()]);
+            if (record != nullptr && record->sequence == sequence)
+            {
+                this->spill(*record);
+            }
+        }
+    }
+}
+
+uint64_t TransitionLog::append(const smacc_msgs::SmaccTransitionLogEntry &entry)
+{
+    auto sequence = nextSequence_.load(std::memory_order_relaxed);
+    auto &slot = slots_[sequence % slots_.size()];
+
+    auto record = std::make_shared<Record>();
+    record->sequence = sequence;
+    record->entry = entry;
+
+    auto evicted = std::atomic_exchange(&slot, std::shared_ptr<const Record>(std::move(record)));
+    nextSequence_.store(sequence + 1, std::memory_order_release);
+
+    if (evicted != nullptr && spillFile_.is_open())
+    {
+        this->spill(*evicted);
+    }
+
+    return sequence;
+}
+
+uint64_t TransitionLog::read(uint64_t fromSequence, std::size_t maxEntries,
+                             std::vector<smacc_msgs::SmaccTransitionLogEntry> &entries, uint64_t &nextSequence) const
+{
+    auto next = nextSequence_.load(std::memory_order_acquire);
+    auto oldest = next > slots_.size() ? next - slots_.size() : 0;
+    auto first = std::min(std::max(fromSequence, oldest), next);
+    auto last = next;
+    if (maxEntries > 0 && last - first > maxEntries)
+    {
+        last = first + maxEntries;
+    }
+
+    uint64_t firstCopied = 0;
+    bool copied = false;
+    for (auto sequence = first; sequence < last; sequence++)
+    {
+        auto record = std::atomic_load(&slots_[sequence % slots_.size()]);
+
+        // the slot may have been overwritten meanwhile by a newer entry (the old one was evicted)
+        if (record == nullptr || record->sequence != sequence)
+        {
+            continue;
+        }
+
+        if (!copied)
+        {
+            firstCopied = sequence;
+            copied = true;
+        }
+
+        entries.push_back(record->entry);
+    }
+
+    nextSequence = last;
+    return copied ? firstCopied : last;
+}
+
+uint64_t TransitionLog::getNextSequence() const
+{
+    return nextSequence_.load(std::memory_order_acquire);
+}
+
+uint64_t TransitionLog::getOldestSequence() const
+{
+    auto next = nextSequence_.load(std::memory_order_acquire);
+    return next > slots_.size() ? next - slots_.size() : 0;
+}
+
+std::size_t TransitionLog::getCapacity() const
+{
+    return slots_.size();
+}
+
+void TransitionLog::spill(const Record &record)
+{
+    uint32_t size = ros::serialization::serializationLength(record.entry);
+    spillBuffer_.resize(size);
+
+    ros::serialization::OStream stream(spillBuffer_.data(), size);
+    ros::serialization::serialize(stream, record.entry);
+
+    spillFile_.write(reinterpret_cast<const char *>(&record.sequence), sizeof(record.sequence));
+    spillFile_.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    spillFile_.write(reinterpret_cast<const char *>(spillBuffer_.data()), size);
+}
+} // namespace smacc
@@ -0,0 +1,45 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#include <smacc/smacc_type_index.h>
+
+#include <map>
+#include <mutex>
+#include <typeindex>
+
+namespace smacc
+{
+namespace type_index_detail
+{
+namespace
+{
+std::mutex &getMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::map<std::type_index, std::size_t> &getCounters()
+{
+    static std::map<std::type_index, std::size_t> counters;
+    return counters;
+}
+} // namespace
+
+std::size_t allocateTypeIndex(const std::type_info &family)
+{
+    std::lock_guard<std::mutex> lock(getMutex());
+    return getCounters()[std::type_index(family)]++;
+}
+
+std::size_t getTypeIndexCount(const std::type_info &family)
+{
+    std::lock_guard<std::mutex> lock(getMutex());
+    auto &counters = getCounters();
+    auto it = counters.find(std::type_index(family));
+    return it != counters.end() ? it->second : 0;
+}
+} // namespace type_index_detail
+} // namespace smacc
@@ -1,16 +1,32 @@
 #include <smacc/smacc_updatable.h>
+#include <ros/ros.h>
+#include <ros/callback_queue.h>
+#include <boost/make_shared.hpp>
+#include <algorithm>
 
 namespace smacc
 {
 
 ISmaccUpdatable::ISmaccUpdatable()
-    : lastUpdate_(0)
+    : lastUpdate_(0),
+      scheduledDeadline_(0),
+      onDemand_(false),
+      threadSafe_(false),
+      updateInProgress_(false),
+      retired_(false),
+      statistics_()
 {
 }
 
 ISmaccUpdatable::ISmaccUpdatable(ros::Duration duration)
     : lastUpdate_(0),
-      periodDuration_(duration)
+      periodDuration_(duration),
+      scheduledDeadline_(0),
+      onDemand_(false),
+      threadSafe_(false),
+      updateInProgress_(false),
+      retired_(false),
+      statistics_()
 {
 }
 
@@ -19,23 +35,220 @@ void ISmaccUpdatable::setUpdatePeriod(ros::Duration duration)
     periodDuration_ = duration;
 }
 
+void ISmaccUpdatable::setUpdateRate(double hz)
+{
+    if (!(hz > 0))
+    {
+        ROS_ERROR("Incorrect update rate: %lf Hz (it must be positive), the update period is not changed", hz);
+        return;
+    }
+
+    periodDuration_ = ros::Duration(1.0 / hz);
+}
+
+void ISmaccUpdatable::setUpdateThreadSafe(bool threadSafe)
+{
+    threadSafe_ = threadSafe;
+}
+
+bool ISmaccUpdatable::isUpdateThreadSafe() const
+{
+    return threadSafe_;
+}
+
+UpdateStatistics ISmaccUpdatable::getUpdateStatistics() const
+{
+    std::lock_guard<std::mutex> lock(statisticsMutex_);
+    return statistics_;
+}
+
+void ISmaccUpdatable::scheduleUpdate(ros::Time deadline)
+{
+    uint64_t deadlineNs = std::max<uint64_t>(deadline.toNSec(), 1);
+
+    // keep the earliest deadline if there was already one scheduled
+    bool lowered = false;
+    uint64_t current = scheduledDeadline_.load();
+    while (current == 0 || deadlineNs < current)
+    {
+        if (scheduledDeadline_.compare_exchange_weak(current, deadlineNs))
+        {
+            lowered = true;
+            break;
+        }
+    }
+
+    // the polling signal detectors find the deadline in their next iteration, and an earlier deadline was already
+    // notified
+    if (lowered && isSignalDetectorEventDriven())
+    {
+        wakeUpSignalDetector();
+    }
+}
+
+void ISmaccUpdatable::requestUpdate()
+{
+    scheduleUpdate(ros::Time::now());
+}
+
+void ISmaccUpdatable::setUpdateOnDemand(bool onDemand)
+{
+    onDemand_ = onDemand;
+}
+
+bool ISmaccUpdatable::isUpdateOnDemand() const
+{
+    return onDemand_;
+}
+
+boost::optional<ros::Time> ISmaccUpdatable::getNextUpdateDeadline() const
+{
+    boost::optional<ros::Time> deadline;
+
+    uint64_t scheduled = scheduledDeadline_.load();
+    if (scheduled != 0)
+    {
+        ros::Time scheduledTime;
+        scheduledTime.fromNSec(scheduled);
+        deadline = scheduledTime;
+    }
+
+    if (periodDuration_)
+    {
+        auto periodDeadline = lastUpdate_ + *periodDuration_;
+        if (!deadline || periodDeadline < *deadline)
+            deadline = periodDeadline;
+    }
+
+    return deadline;
+}
+
 void ISmaccUpdatable::executeUpdate()
+{
+    if (this->checkUpdateDue(ros::Time::now()))
+    {
+        this->runUpdate();
+    }
+}
+
+bool ISmaccUpdatable::checkUpdateDue(const ros::Time &now)
 {
     bool update = true;
-    if (periodDuration_)
+
+    uint64_t scheduled = scheduledDeadline_.load();
+    if (scheduled != 0 && now.toNSec() >= scheduled)
+    {
+        // a newer deadline may have been scheduled meanwhile, in that case it is kept
+        scheduledDeadline_.compare_exchange_strong(scheduled, 0);
+    }
+    else if (periodDuration_)
     {
-        auto now = ros::Time::now();
         auto ellapsed = now - this->lastUpdate_;
-        update = ellapsed > *periodDuration_;
-        if(update)
-        {
-            this->lastUpdate_ = now;
-        }
+        update = ellapsed >= *periodDuration_;
+    }
+    else
+    {
+        update = !onDemand_;
     }
 
     if (update)
     {
-        this->update();
+        this->lastUpdate_ = now;
+    }
+
+    return update;
+}
+
+void ISmaccUpdatable::runUpdate()
+{
+    auto start = std::chrono::steady_clock::now();
+    this->update();
+    double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::lock_guard<std::mutex> lock(statisticsMutex_);
+    statistics_.updateCount++;
+    statistics_.lastDuration = duration;
+    statistics_.maxDuration = std::max(statistics_.maxDuration, duration);
+    statistics_.meanDuration += (duration - statistics_.meanDuration) / statistics_.updateCount;
+
+    if (periodDuration_ && duration > periodDuration_->toSec())
+    {
+        statistics_.overrunCount++;
     }
 }
-}
\ No newline at end of file
+
+bool ISmaccUpdatable::tryBeginAsyncUpdate()
+{
+    bool expected = false;
+    if (!updateInProgress_.compare_exchange_strong(expected, true))
+    {
+        return false;
+    }
+
+    // retireUpdates sets retired_ before checking updateInProgress_ (both seq_cst), so at least one of
+    // the two threads sees the other
+    if (retired_)
+    {
+        updateInProgress_ = false;
+        return false;
+    }
+
+    return true;
+}
+
+void ISmaccUpdatable::endAsyncUpdate()
+{
+    // notified with the mutex held: retireUpdates cannot miss the notification, and it cannot return (and the
+    // updatable cannot be destroyed) until this thread does not access the condition variable anymore
+    std::lock_guard<std::mutex> lock(updateFinishedMutex_);
+    updateInProgress_ = false;
+    updateFinished_.notify_all();
+}
+
+void ISmaccUpdatable::countSkippedUpdate()
+{
+    std::lock_guard<std::mutex> lock(statisticsMutex_);
+    statistics_.skippedCount++;
+}
+
+void ISmaccUpdatable::retireUpdates()
+{
+    retired_ = true;
+
+    std::unique_lock<std::mutex> lock(updateFinishedMutex_);
+    updateFinished_.wait(lock, [this] { return !updateInProgress_; });
+}
+
+namespace
+{
+std::atomic<int> eventDrivenSignalDetectors(0);
+
+class WakeUpCallback : public ros::CallbackInterface
+{
+public:
+    virtual CallResult call() override
+    {
+        return Success;
+    }
+};
+} // namespace
+
+void wakeUpSignalDetector()
+{
+    // the signal detector waits on the global callback queue (where the ros callbacks are also processed)
+    ros::getGlobalCallbackQueue()->addCallback(boost::make_shared<WakeUpCallback>());
+}
+
+void setSignalDetectorEventDriven(bool eventDriven)
+{
+    if (eventDriven)
+        eventDrivenSignalDetectors++;
+    else
+        eventDrivenSignalDetectors--;
+}
+
+bool isSignalDetectorEventDriven()
+{
+    return eventDrivenSignalDetectors > 0;
+}
+}
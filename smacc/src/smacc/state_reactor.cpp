@@ -32,6 +32,18 @@ void StateReactor::onExit()
 
 }
 
+void StateReactor::notifyEvent(const boost::statechart::event_base &ev)
+{
+    this->onEventNotified(&typeid(ev));
+    this->update();
+
+    auto it = eventCallbacks_.find(ev.dynamic_type());
+    if (it != eventCallbacks_.end())
+    {
+        it->second(ev);
+    }
+}
+
 void StateReactor::update()
 {
     if (this->triggers())
@@ -41,6 +53,14 @@ void StateReactor::update()
     }
 }
 
+void StateReactorDispatchTable::addStateReactor(const std::shared_ptr<StateReactor> &sr)
+{
+    for (auto eventType : sr->getInputEventIds())
+    {
+        reactors_[eventType].push_back(sr);
+    }
+}
+
 namespace introspection
 {
 void StateReactorHandler::configureStateReactor(std::shared_ptr<smacc::StateReactor> sb)
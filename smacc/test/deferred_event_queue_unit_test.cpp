@@ -0,0 +1,191 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#include <smacc/smacc_deferred_event_queue.h>
+
+#include <boost/statechart/event.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace smacc;
+
+namespace
+{
+std::atomic<long> liveEvents(0);
+
+struct EvTest : boost::statechart::event<EvTest>
+{
+    static const unsigned long MAGIC = 0x5a5a5a5a;
+
+    EvTest(int producer, int seq) : producer(producer), seq(seq), magic(MAGIC)
+    {
+        liveEvents++;
+    }
+
+    ~EvTest()
+    {
+        magic = 0;
+        liveEvents--;
+    }
+
+    int producer;
+    int seq;
+    unsigned long magic;
+};
+
+// mirrors ISmaccStateMachine::postEvent for a current state scoped event
+template <typename TPost>
+void postCurrentStateEvent(DeferredEventQueue &queue, std::atomic<bool> &transitioning, EvTest *ev, TPost post)
+{
+    DeferredEventQueue::EventPtr event(ev);
+
+    if (transitioning && queue.defer(event, 1, [&]() { return transitioning.load(); }))
+        return;
+
+    post(event);
+}
+} // namespace
+
+TEST(DeferredEventQueueTest, deferredEventsAreDeliveredInOrder)
+{
+    DeferredEventQueue queue(10, DeferredEventQueue::Policy::DELIVER);
+
+    for (int i = 0; i < 5; i++)
+        ASSERT_TRUE(queue.defer(new EvTest(0, i), 1, []() { return true; }));
+
+    std::vector<int> delivered;
+    queue.flush(2, [&](const DeferredEventQueue::EventPtr &ev) {
+        delivered.push_back(static_cast<const EvTest *>(ev.get())->seq);
+    });
+
+    ASSERT_EQ(delivered, (std::vector<int>{0, 1, 2, 3, 4}));
+    ASSERT_EQ(queue.getStatistics().deferred, 5u);
+    ASSERT_EQ(queue.getStatistics().delivered, 5u);
+    ASSERT_EQ(liveEvents, 0);
+}
+
+TEST(DeferredEventQueueTest, eventsAreDroppedWhenTheQueueIsFull)
+{
+    DeferredEventQueue queue(2, DeferredEventQueue::Policy::DELIVER);
+
+    for (int i = 0; i < 5; i++)
+        ASSERT_TRUE(queue.defer(new EvTest(0, i), 1, []() { return true; }));
+
+    int delivered = 0;
+    queue.flush(2, [&](const DeferredEventQueue::EventPtr &) { delivered++; });
+
+    ASSERT_EQ(delivered, 2);
+    ASSERT_EQ(queue.getStatistics().dropped, 3u);
+    ASSERT_EQ(liveEvents, 0);
+}
+
+TEST(DeferredEventQueueTest, discardDropsTheEventsOfTheExitedStates)
+{
+    DeferredEventQueue queue(10, DeferredEventQueue::Policy::DISCARD);
+
+    // posted while the state 1 was exiting
+    ASSERT_TRUE(queue.defer(new EvTest(0, 0), 1, []() { return true; }));
+    ASSERT_TRUE(queue.defer(new EvTest(0, 1), 1, []() { return true; }));
+    // posted while the state 2 was being created
+    ASSERT_TRUE(queue.defer(new EvTest(0, 2), 2, []() { return true; }));
+
+    std::vector<int> delivered;
+    queue.flush(2, [&](const DeferredEventQueue::EventPtr &ev) {
+        delivered.push_back(static_cast<const EvTest *>(ev.get())->seq);
+    });
+
+    ASSERT_EQ(delivered, (std::vector<int>{2}));
+    ASSERT_EQ(queue.getStatistics().dropped, 2u);
+    ASSERT_EQ(queue.getStatistics().delivered, 1u);
+    ASSERT_EQ(liveEvents, 0);
+}
+
+TEST(DeferredEventQueueTest, eventsAreNotDeferredOnceTheTransitionFinished)
+{
+    DeferredEventQueue queue(10, DeferredEventQueue::Policy::DISCARD);
+
+    ASSERT_FALSE(queue.defer(new EvTest(0, 0), 1, []() { return false; }));
+    ASSERT_EQ(queue.getStatistics().deferred, 0u);
+    ASSERT_EQ(liveEvents, 0);
+}
+
+// the transition finishes between the isTransitioning check of the producer and the deferral: defer returns false
+// and the producer must still own a valid event to post it
+TEST(DeferredEventQueueTest, eventsNotDeferredRemainValid)
+{
+    const int producers = 4;
+    const int eventsPerProducer = 20000;
+
+    DeferredEventQueue queue(eventsPerProducer * producers, DeferredEventQueue::Policy::DELIVER);
+    std::atomic<bool> transitioning(true);
+    std::atomic<bool> finished(false);
+
+    std::mutex receivedMutex;
+    std::vector<std::vector<int>> received(producers);
+    std::atomic<long> corrupted(0);
+
+    auto post = [&](const DeferredEventQueue::EventPtr &ev) {
+        auto *event = static_cast<const EvTest *>(ev.get());
+        if (event->magic != EvTest::MAGIC)
+        {
+            corrupted++;
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(receivedMutex);
+        received[event->producer].push_back(event->seq);
+    };
+
+    // the state machine thread: transitions continuously and flushes the deferred events once steady
+    std::thread stateMachine([&]() {
+        while (!finished)
+        {
+            transitioning = true;
+            std::this_thread::yield();
+            transitioning = false;
+            queue.flush(2, post);
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&, p]() {
+            for (int i = 0; i < eventsPerProducer; i++)
+                postCurrentStateEvent(queue, transitioning, new EvTest(p, i), post);
+        });
+    }
+
+    for (auto &t : threads)
+        t.join();
+
+    finished = true;
+    stateMachine.join();
+    queue.flush(2, post);
+
+    ASSERT_EQ(corrupted, 0);
+    ASSERT_EQ(liveEvents, 0);
+    ASSERT_EQ(queue.getStatistics().dropped, 0u);
+
+    // no event is lost nor delivered twice
+    for (auto &events : received)
+    {
+        ASSERT_EQ(events.size(), (std::size_t)eventsPerProducer);
+        std::sort(events.begin(), events.end());
+        for (int i = 0; i < eventsPerProducer; i++)
+            ASSERT_EQ(events[i], i);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
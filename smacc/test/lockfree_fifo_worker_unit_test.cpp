@@ -0,0 +1,134 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#include <smacc/smacc_lockfree_fifo_worker.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace smacc;
+
+// a small ring so that the producers switch continuously between the ring and the overflow list
+typedef SmaccLockFreeFifoWorker<std::allocator<void>, 8> SmallFifoWorker;
+
+TEST(LockFreeFifoWorkerTest, overflowKeepsTheOrder)
+{
+    SmallFifoWorker worker(false);
+    std::vector<int> executed;
+
+    // without consumer: the first items fill the ring and the rest go to the overflow list
+    for (int i = 0; i < 100; i++)
+        worker.queue_work_item([&executed, i]() { executed.push_back(i); });
+
+    ASSERT_EQ(worker.getOverflowCount(), 92u);
+
+    // the overflow is drained in the middle, the next items go to the ring again
+    ASSERT_EQ(worker(50), 50u);
+    for (int i = 100; i < 200; i++)
+        worker.queue_work_item([&executed, i]() { executed.push_back(i); });
+
+    ASSERT_EQ(worker(), 150u);
+
+    ASSERT_EQ(executed.size(), 200u);
+    for (int i = 0; i < 200; i++)
+        ASSERT_EQ(executed[i], i);
+}
+
+TEST(LockFreeFifoWorkerTest, severalProducersNoLossNorReordering)
+{
+    const int producers = 4;
+    const int itemsPerProducer = 50000;
+
+    SmallFifoWorker worker(true);
+
+    // only accessed by the consumer thread
+    std::vector<int> lastSeq(producers, -1);
+    std::vector<int> count(producers, 0);
+    int outOfOrder = 0;
+    unsigned long processed = 0;
+
+    std::thread consumer([&]() { worker(); });
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&, p]() {
+            for (int i = 0; i < itemsPerProducer; i++)
+            {
+                worker.queue_work_item([&, p, i]() {
+                    if (i <= lastSeq[p])
+                        outOfOrder++;
+
+                    lastSeq[p] = i;
+                    count[p]++;
+
+                    // a slow consumer from time to time, the ring fills up
+                    if (++processed % 5000 == 0)
+                        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                });
+            }
+        });
+    }
+
+    for (auto &t : threads)
+        t.join();
+
+    // the termination is processed after all the previous items
+    worker.terminate();
+    consumer.join();
+
+    ASSERT_TRUE(worker.terminated());
+    ASSERT_EQ(outOfOrder, 0);
+    for (int p = 0; p < producers; p++)
+        ASSERT_EQ(count[p], itemsPerProducer);
+
+    ASSERT_GT(worker.getOverflowCount(), 0u);
+}
+
+TEST(LockFreeFifoWorkerTest, terminateStopsTheConsumer)
+{
+    SmallFifoWorker worker(false);
+    int executed = 0;
+
+    worker.queue_work_item([&executed]() { executed++; });
+    worker.terminate();
+    worker.queue_work_item([&executed]() { executed++; });
+
+    ASSERT_FALSE(worker.terminated());
+
+    // the item and the termination
+    ASSERT_EQ(worker(), 2u);
+    ASSERT_TRUE(worker.terminated());
+    ASSERT_EQ(executed, 1);
+
+    // terminated workers do not execute more items
+    ASSERT_EQ(worker(), 0u);
+    ASSERT_EQ(executed, 1);
+}
+
+TEST(LockFreeFifoWorkerTest, blockedConsumerIsWokenUp)
+{
+    SmallFifoWorker worker(true);
+    bool executed = false;
+
+    std::thread consumer([&]() { worker(); });
+
+    // the consumer is already waiting on the empty queue
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    worker.queue_work_item([&executed]() { executed = true; });
+    worker.terminate();
+
+    consumer.join();
+    ASSERT_TRUE(executed);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
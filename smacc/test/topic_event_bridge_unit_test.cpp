@@ -0,0 +1,220 @@
+/*****************************************************************************************************************
+ * ReelRobotix Inc. - Software License Agreement      Copyright (c) 2018
+ * 	 Authors: Pablo Inigo Blasco, Brett Aldrich
+ *
+ ******************************************************************************************************************/
+#include <smacc/smacc_topic_event_policy.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+using namespace smacc;
+
+namespace
+{
+typedef std::shared_ptr<const int> MessageConstPtr;
+
+MessageConstPtr message(int value)
+{
+    return std::make_shared<const int>(value);
+}
+
+// the events posted by the bridge and not processed yet (they keep the conflation token)
+struct PendingEvents
+{
+    std::vector<std::pair<int, std::shared_ptr<void>>> events;
+
+    // releasing a token may post the latest message, so they are processed one by one
+    ~PendingEvents()
+    {
+        while (!events.empty())
+            process();
+    }
+
+    TopicEventBridge<MessageConstPtr>::PostFunction postFunction()
+    {
+        return [this](const MessageConstPtr &msg, std::shared_ptr<void> token) {
+            events.push_back(std::make_pair(*msg, std::move(token)));
+        };
+    }
+
+    // the state machine processes the oldest event
+    int process()
+    {
+        auto event = std::move(events.front());
+        events.erase(events.begin());
+        event.second = nullptr;
+        return event.first;
+    }
+};
+} // namespace
+
+TEST(TopicEventBridgeTest, allPostsEveryMessage)
+{
+    TopicEventBridge<MessageConstPtr> bridge;
+    PendingEvents pending;
+    bridge.setPostFunction(pending.postFunction());
+
+    for (int i = 0; i < 5; i++)
+        bridge.onMessage(message(i));
+
+    ASSERT_EQ(pending.events.size(), 5u);
+    ASSERT_EQ(bridge.getStatistics().received, 5u);
+    ASSERT_EQ(bridge.getStatistics().posted, 5u);
+}
+
+TEST(TopicEventBridgeTest, conflateCountsTheReplacedMessages)
+{
+    TopicEventBridge<MessageConstPtr> bridge;
+    PendingEvents pending;
+    bridge.setPostFunction(pending.postFunction());
+    bridge.setPolicy(TopicEventPolicy::CONFLATE);
+
+    // the first one is posted, 1..3 are replaced by 4 meanwhile it is pending
+    for (int i = 0; i < 5; i++)
+        bridge.onMessage(message(i));
+
+    ASSERT_EQ(pending.events.size(), 1u);
+
+    auto statistics = bridge.getStatistics();
+    ASSERT_EQ(statistics.received, 5u);
+    ASSERT_EQ(statistics.posted, 1u);
+    ASSERT_EQ(statistics.conflated, 3u);
+}
+
+TEST(TopicEventBridgeTest, conflatePostsTheLatestMessageOnTokenRelease)
+{
+    TopicEventBridge<MessageConstPtr> bridge;
+    PendingEvents pending;
+    bridge.setPostFunction(pending.postFunction());
+    bridge.setPolicy(TopicEventPolicy::CONFLATE);
+
+    for (int i = 0; i < 5; i++)
+        bridge.onMessage(message(i));
+
+    ASSERT_EQ(pending.process(), 0);
+
+    // released: the latest message is posted with a new token
+    ASSERT_EQ(pending.events.size(), 1u);
+    ASSERT_EQ(pending.process(), 4);
+
+    // nothing was received meanwhile, the next message is posted directly
+    ASSERT_TRUE(pending.events.empty());
+    bridge.onMessage(message(5));
+    ASSERT_EQ(pending.events.size(), 1u);
+    ASSERT_EQ(pending.process(), 5);
+
+    ASSERT_EQ(bridge.getStatistics().posted, 3u);
+}
+
+TEST(TopicEventBridgeTest, tokenReleasedInsidePost)
+{
+    TopicEventBridge<MessageConstPtr> bridge;
+    PendingEvents pending;
+    std::vector<int> discarded;
+    bool discard = false;
+
+    // the state machine discards the event (ie: the state is exiting), the token is released inside post
+    auto post = pending.postFunction();
+    bridge.setPostFunction([&](const MessageConstPtr &msg, std::shared_ptr<void> token) {
+        if (discard)
+            discarded.push_back(*msg);
+        else
+            post(msg, std::move(token));
+    });
+    bridge.setPolicy(TopicEventPolicy::CONFLATE);
+
+    discard = true;
+    bridge.onMessage(message(0));
+    bridge.onMessage(message(1));
+    ASSERT_EQ(discarded, (std::vector<int>{0, 1}));
+
+    // the latest message is posted (and discarded) inside the release of the first token
+    discard = false;
+    bridge.onMessage(message(2));
+    bridge.onMessage(message(3));
+    discard = true;
+    pending.process();
+    ASSERT_EQ(discarded, (std::vector<int>{0, 1, 3}));
+
+    // nothing is pending
+    discard = false;
+    bridge.onMessage(message(4));
+    ASSERT_EQ(pending.events.size(), 1u);
+    ASSERT_EQ(bridge.getStatistics().conflated, 0u);
+}
+
+TEST(TopicEventBridgeTest, eventsInFlightOutliveTheBridge)
+{
+    PendingEvents pending;
+    int posted = 0;
+
+    {
+        TopicEventBridge<MessageConstPtr> bridge;
+        auto post = pending.postFunction();
+        bridge.setPostFunction([&](const MessageConstPtr &msg, std::shared_ptr<void> token) {
+            posted++;
+            post(msg, std::move(token));
+        });
+        bridge.setPolicy(TopicEventPolicy::CONFLATE);
+
+        bridge.onMessage(message(0));
+        bridge.onMessage(message(1));
+    }
+
+    // the bridge cleared its post function: the latest message is not posted when the token is released
+    ASSERT_EQ(pending.process(), 0);
+    ASSERT_TRUE(pending.events.empty());
+    ASSERT_EQ(posted, 1);
+}
+
+TEST(TopicEventBridgeTest, decimateDropsTheMessagesAboveTheRate)
+{
+    TopicEventBridge<MessageConstPtr> bridge;
+    PendingEvents pending;
+    bridge.setPostFunction(pending.postFunction());
+
+    ASSERT_TRUE(bridge.setPolicy(TopicEventPolicy::DECIMATE, 0.001));
+    for (int i = 0; i < 5; i++)
+        bridge.onMessage(message(i));
+
+    ASSERT_EQ(pending.events.size(), 1u);
+    ASSERT_EQ(bridge.getStatistics().decimated, 4u);
+}
+
+TEST(TopicEventBridgeTest, decimateRejectsNonPositiveRates)
+{
+    TopicEventBridge<MessageConstPtr> bridge;
+
+    ASSERT_FALSE(bridge.setPolicy(TopicEventPolicy::DECIMATE, 0));
+    ASSERT_FALSE(bridge.setPolicy(TopicEventPolicy::DECIMATE, -1));
+    ASSERT_EQ(bridge.getPolicy(), TopicEventPolicy::ALL);
+
+    ASSERT_TRUE(bridge.setPolicy(TopicEventPolicy::CONFLATE));
+    ASSERT_FALSE(bridge.setPolicy(TopicEventPolicy::DECIMATE, 0));
+    ASSERT_EQ(bridge.getPolicy(), TopicEventPolicy::CONFLATE);
+}
+
+TEST(TopicEventBridgeTest, signalOnlyDoesNotPost)
+{
+    TopicEventBridge<MessageConstPtr> bridge;
+    PendingEvents pending;
+    bridge.setPostFunction(pending.postFunction());
+    bridge.setPolicy(TopicEventPolicy::SIGNAL_ONLY);
+
+    bridge.onMessage(message(0));
+
+    ASSERT_TRUE(pending.events.empty());
+    ASSERT_EQ(bridge.getStatistics().signalOnly, 1u);
+}
+
+int main(int argc, char **argv)
+{
+    // decimate uses ros::Time::now without a node
+    ros::Time::init();
+
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
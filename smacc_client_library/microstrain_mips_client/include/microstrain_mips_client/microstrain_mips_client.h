@@ -140,6 +140,10 @@ public:
         this->imuSubscriber = this->createComponent<TSourceObject, TOrthogonal, smacc::components::CpTopicSubscriber<sensor_msgs::Imu>>("imu/data");
         this->imuFilteredSubscriber = this->createComponent<TSourceObject, TOrthogonal, smacc::components::CpTopicSubscriber<sensor_msgs::Imu>>("filtered/imu/data");
         this->statusSubscriber = this->createComponent<TSourceObject, TOrthogonal, smacc::components::CpTopicSubscriber<microstrain_mips::status_msg>>("imu/data");
+
+        // high rate topics: only the latest imu message is kept pending in the event queue
+        this->imuSubscriber->setEventPolicy(smacc::TopicEventPolicy::CONFLATE);
+        this->imuFilteredSubscriber->setEventPolicy(smacc::TopicEventPolicy::CONFLATE);
     }
 
     void resetFilter()
@@ -19,6 +19,10 @@ namespace cl_move_base_z
           m_mutex_()
     {
         this->pose_.header.frame_id = referenceFrame_;
+
+        // the pose is protected by m_mutex_, the tf lookup does not need to block the other updatables
+        this->setUpdateThreadSafe(true);
+
         ROS_INFO("[Pose] Creating Pose tracker component to track %s in the reference frame %s", targetFrame.c_str(), referenceFrame.c_str());
 
         {
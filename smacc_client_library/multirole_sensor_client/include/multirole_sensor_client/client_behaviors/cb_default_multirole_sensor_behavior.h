@@ -10,6 +10,7 @@ class CbDefaultMultiRoleSensorBehavior : public smacc::SmaccClientBehavior
 {
 public:
   typedef typename ClientType::TMessageType TMessageType;
+  typedef typename ClientType::TMessageConstPtr TMessageConstPtr;
 
   ClientType *sensor_;
 
@@ -31,16 +32,19 @@ public:
   {
     deferedEventPropagation = [=]() {
       // just propagate the client events from this client behavior source.
-      sensor_->onMessageReceived(&CbDefaultMultiRoleSensorBehavior<ClientType>::propagateEvent<EvTopicMessage<TSourceObject, TOrthogonal>>, this);
-      sensor_->onFirstMessageReceived(&CbDefaultMultiRoleSensorBehavior<ClientType>::propagateEvent<EvTopicInitialMessage<TSourceObject, TOrthogonal>>, this);
+      sensor_->onMessagePtrReceived(&CbDefaultMultiRoleSensorBehavior<ClientType>::propagateEvent<EvTopicMessage<TSourceObject, TOrthogonal>>, this);
+      sensor_->onFirstMessagePtrReceived(&CbDefaultMultiRoleSensorBehavior<ClientType>::propagateEvent<EvTopicInitialMessage<TSourceObject, TOrthogonal>>, this);
       sensor_->onMessageTimeout(&CbDefaultMultiRoleSensorBehavior<ClientType>::propagateEvent2<EvTopicMessageTimeout<TSourceObject, TOrthogonal>>, this);
     };
   }
 
+  // the event shares the message of the sensor client
   template <typename EvType>
-  void propagateEvent(const TMessageType &msg)
+  void propagateEvent(const TMessageConstPtr &msg)
   {
-    this->postEvent<EvType>();
+    auto *ev = new EvType();
+    ev->msgData = msg;
+    this->postEvent(ev);
   }
 
   template <typename EvType>
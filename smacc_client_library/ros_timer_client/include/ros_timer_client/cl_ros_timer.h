@@ -36,6 +36,12 @@ public:
         return this->getStateMachine()->createSignalConnection(onTimerTick_, callback, object);
     }
 
+    // ie: co_await awaitSignal(timer->getTimerTickSignal()) in a SmaccCoroutineClientBehavior
+    smacc::SmaccSignal<void()> &getTimerTickSignal()
+    {
+        return onTimerTick_;
+    }
+
     template <typename TOrthogonal, typename TSourceObject>
     void onOrthogonalAllocation()
     {
@@ -0,0 +1,52 @@
+#include <smacc/smacc_coroutine_client_behavior.h>
+
+#if !defined(__cpp_impl_coroutine)
+#error "sm_coretest_coroutine_1 must be compiled with coroutine support (C++20)"
+#endif
+
+#include <ros_timer_client/cl_ros_timer.h>
+#include <sm_coretest_coroutine_1/clients/cl_counter_subscriber.h>
+#include <sm_coretest_coroutine_1/clients/cl_test_action.h>
+
+namespace sm_coretest_coroutine_1
+{
+// awaits each kind of value once: a timer tick, a sleep, a topic message and an action result
+class CbCoroutineSequence : public smacc::SmaccCoroutineClientBehavior
+{
+public:
+    smacc::CbCoroutine onEntryCoroutine() override
+    {
+        cl_ros_timer::ClRosTimer *timerClient;
+        ClCounterSubscriber *subscriberClient;
+        ClTestAction *actionClient;
+
+        this->requiresClient(timerClient);
+        this->requiresClient(subscriberClient);
+        this->requiresClient(actionClient);
+
+        co_await awaitSignal(timerClient->getTimerTickSignal());
+        co_await sleep(ros::Duration(0.1));
+
+        auto msg = co_await awaitMessage(*subscriberClient);
+
+        while (!actionClient->isServerConnected())
+        {
+            co_await sleep(ros::Duration(0.1));
+        }
+
+        ClTestAction::Goal goal;
+        goal.goal = msg->data;
+        actionClient->sendGoal(goal);
+
+        auto result = co_await awaitResult(*actionClient);
+        if (result.type != smacc::CbActionResultType::SUCCEEDED || result.result->result != goal.goal)
+        {
+            ROS_ERROR("[CbCoroutineSequence] unexpected action result for the goal %d", goal.goal);
+        }
+        else
+        {
+            ROS_INFO("[CbCoroutineSequence] sequence finished, counter: %d", msg->data);
+        }
+    }
+};
+} // namespace sm_coretest_coroutine_1
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <smacc/client_bases/smacc_subscriber_client.h>
+#include <std_msgs/Int32.h>
+
+namespace sm_coretest_coroutine_1
+{
+class ClCounterSubscriber : public smacc::client_bases::SmaccSubscriberClient<std_msgs::Int32>
+{
+public:
+    using SmaccSubscriberClient::SmaccSubscriberClient;
+};
+} // namespace sm_coretest_coroutine_1
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <smacc/client_bases/smacc_action_client_base.h>
+#include <actionlib/TestAction.h>
+
+namespace sm_coretest_coroutine_1
+{
+class ClTestAction : public smacc::client_bases::SmaccActionClientBase<actionlib::TestAction>
+{
+public:
+    SMACC_ACTION_CLIENT_DEFINITION(actionlib::TestAction);
+
+    ClTestAction(std::string actionServerName)
+        : Base(actionServerName)
+    {
+    }
+
+    bool isServerConnected()
+    {
+        return client_->isServerConnected();
+    }
+};
+} // namespace sm_coretest_coroutine_1
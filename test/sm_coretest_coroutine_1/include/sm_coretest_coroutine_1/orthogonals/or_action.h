@@ -0,0 +1,15 @@
+#include <smacc/smacc.h>
+#include <sm_coretest_coroutine_1/clients/cl_test_action.h>
+
+namespace sm_coretest_coroutine_1
+{
+class OrAction : public smacc::Orthogonal<OrAction>
+{
+public:
+    virtual void onInitialize() override
+    {
+        auto client = this->createClient<ClTestAction>("coroutine_test_action");
+        client->initialize();
+    }
+};
+} // namespace sm_coretest_coroutine_1
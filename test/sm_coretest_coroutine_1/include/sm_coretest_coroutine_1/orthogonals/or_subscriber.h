@@ -0,0 +1,15 @@
+#include <smacc/smacc.h>
+#include <sm_coretest_coroutine_1/clients/cl_counter_subscriber.h>
+
+namespace sm_coretest_coroutine_1
+{
+class OrSubscriber : public smacc::Orthogonal<OrSubscriber>
+{
+public:
+    virtual void onInitialize() override
+    {
+        auto client = this->createClient<ClCounterSubscriber>("coroutine_counter");
+        client->initialize();
+    }
+};
+} // namespace sm_coretest_coroutine_1
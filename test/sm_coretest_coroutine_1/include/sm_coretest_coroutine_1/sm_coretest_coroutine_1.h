@@ -0,0 +1,48 @@
+#include <smacc/smacc.h>
+
+// CLIENTS
+#include <ros_timer_client/cl_ros_timer.h>
+#include <sm_coretest_coroutine_1/clients/cl_counter_subscriber.h>
+#include <sm_coretest_coroutine_1/clients/cl_test_action.h>
+
+// ORTHOGONALS
+#include <sm_coretest_coroutine_1/orthogonals/or_action.h>
+#include <sm_coretest_coroutine_1/orthogonals/or_subscriber.h>
+#include <sm_coretest_coroutine_1/orthogonals/or_timer.h>
+
+//CLIENT BEHAVIORS
+#include <sm_coretest_coroutine_1/client_behaviors/cb_coroutine_sequence.h>
+
+using namespace boost;
+using namespace smacc;
+
+namespace sm_coretest_coroutine_1
+{
+
+struct AutomaticTransitionEvent : sc::event<AutomaticTransitionEvent>
+{
+};
+
+//STATE
+class State1;
+class State2;
+
+//--------------------------------------------------------------------
+//STATE_MACHINE
+struct SmCoreTestCoroutine1
+    : public smacc::SmaccStateMachineBase<SmCoreTestCoroutine1, State1>
+{
+    using SmaccStateMachineBase::SmaccStateMachineBase;
+
+    virtual void onInitialize() override
+    {
+        this->createOrthogonal<OrTimer>();
+        this->createOrthogonal<OrSubscriber>();
+        this->createOrthogonal<OrAction>();
+    }
+};
+
+} // namespace sm_coretest_coroutine_1
+
+#include <sm_coretest_coroutine_1/states/st_state_1.h>
+#include <sm_coretest_coroutine_1/states/st_state_2.h>
@@ -0,0 +1,22 @@
+#include <smacc/smacc.h>
+
+namespace sm_coretest_coroutine_1
+{
+// STATE DECLARATION
+struct State1 : smacc::SmaccState<State1, SmCoreTestCoroutine1>
+{
+    using SmaccState::SmaccState;
+
+    // TRANSITION TABLE
+    typedef mpl::list<
+
+        Transition<EvCbFinished<CbCoroutineSequence, OrTimer>, State2, SUCCESS>>
+        reactions;
+
+    // STATE FUNCTIONS
+    static void staticConfigure()
+    {
+        configure_orthogonal<OrTimer, CbCoroutineSequence>();
+    }
+};
+} // namespace sm_coretest_coroutine_1
@@ -0,0 +1,26 @@
+#include <smacc/smacc.h>
+
+namespace sm_coretest_coroutine_1
+{
+// STATE DECLARATION
+struct State2 : smacc::SmaccState<State2, SmCoreTestCoroutine1>
+{
+    using SmaccState::SmaccState;
+
+    // TRANSITION TABLE
+    typedef mpl::list<
+
+        Transition<AutomaticTransitionEvent, State1, SUCCESS>>
+        reactions;
+
+    // STATE FUNCTIONS
+    static void staticConfigure()
+    {
+    }
+
+    void onEntry()
+    {
+        this->postEvent<AutomaticTransitionEvent>();
+    }
+};
+} // namespace sm_coretest_coroutine_1
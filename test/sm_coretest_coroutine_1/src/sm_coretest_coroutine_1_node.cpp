@@ -0,0 +1,31 @@
+#include <sm_coretest_coroutine_1/sm_coretest_coroutine_1.h>
+
+#include <actionlib/server/simple_action_server.h>
+
+//--------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    ros::init(argc, argv, "sm_coretest_coroutine_1");
+    ros::NodeHandle nh;
+
+    // the counter awaited by the coroutine (awaitMessage)
+    int counter = 0;
+    auto publisher = nh.advertise<std_msgs::Int32>("coroutine_counter", 1);
+    auto timer = nh.createTimer(ros::Duration(0.1), [&](const ros::TimerEvent &) {
+        std_msgs::Int32 msg;
+        msg.data = counter++;
+        publisher.publish(msg);
+    });
+
+    // echoes the goal (awaitResult)
+    actionlib::SimpleActionServer<actionlib::TestAction> server(
+        nh, "coroutine_test_action", [&server](const actionlib::TestGoalConstPtr &goal) {
+            actionlib::TestResult result;
+            result.result = goal->goal;
+            server.setSucceeded(result);
+        },
+        false);
+    server.start();
+
+    smacc::run<sm_coretest_coroutine_1::SmCoreTestCoroutine1>();
+}